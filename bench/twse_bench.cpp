@@ -0,0 +1,252 @@
+// Microbenchmarks for the parse/load/serialize hot paths.
+//
+// Build and run with `make bench`. Each benchmark runs against synthetic
+// records (generators below produce layout-valid 59/186/63-char lines), is
+// repeated until it has accumulated enough wall time to be stable, and
+// reports records/sec and MB/sec, so a change to e.g. parseSnapshotLine can
+// be judged in isolation from production data and disk I/O.
+//
+// The harness is deliberately self-contained: the repo vendors only
+// single-header dependencies, so instead of pulling in Google Benchmark we
+// use the same measure-until-stable loop it popularized.
+
+#include "../twse_tick.hpp"
+#include "../twse_json.hpp"
+#include "../twse_mmap.hpp"
+#include "../twse_packed.hpp"
+#include "../twse_parallel.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+
+//------------------------------------------------------------------------------
+// 1. Harness
+//------------------------------------------------------------------------------
+
+// Repeat fn() until ~0.5s has elapsed (at least 3 times), then report
+// throughput. fn returns the number of records it processed.
+inline void runBench(const char *name, size_t bytes_per_run,
+                     const std::function<size_t()> &fn)
+{
+    using Clock = std::chrono::steady_clock;
+    // warm-up
+    fn();
+
+    double elapsed = 0.0;
+    size_t runs = 0;
+    size_t records = 0;
+    while (elapsed < 0.5 || runs < 3)
+    {
+        auto t0 = Clock::now();
+        records += fn();
+        auto t1 = Clock::now();
+        elapsed += std::chrono::duration<double>(t1 - t0).count();
+        runs++;
+    }
+    double recs_per_sec = static_cast<double>(records) / elapsed;
+    double mb_per_sec = static_cast<double>(bytes_per_run) * runs / elapsed / 1e6;
+    std::printf("%-34s %12.0f rec/s %10.1f MB/s  (%zu runs)\n",
+                name, recs_per_sec, mb_per_sec, runs);
+}
+
+//------------------------------------------------------------------------------
+// 2. Synthetic record generators
+//------------------------------------------------------------------------------
+
+inline std::string makeOrderLine(size_t i)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf),
+                  "20241111%04zu  B0%08zu%05zu10078.35+00000010000 0000M0000",
+                  1000 + i % 2000, 9000000 + i % 1000000, i % 100000);
+    std::string line(buf);
+    line.resize(59, ' ');
+    return line;
+}
+
+inline std::string makeSnapshotLine(size_t i)
+{
+    std::string line;
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%04zu  %08zu", 1000 + i % 2000, 9000000 + i % 1000000);
+    line += buf;        // code + time
+    line += "  Y ";     // remark, trend, match, upper/lower
+    line += "002860";   // trade price
+    std::snprintf(buf, sizeof(buf), "%08zu", i % 100000);
+    line += buf; // transaction volume
+    line += "5 ";
+    for (int lvl = 0; lvl < 5; lvl++)
+    {
+        std::snprintf(buf, sizeof(buf), "%06d%08zu", 2860 - lvl * 5, 100 + i % 1000);
+        line += buf;
+    }
+    line += "5 ";
+    for (int lvl = 0; lvl < 5; lvl++)
+    {
+        std::snprintf(buf, sizeof(buf), "%06d%08zu", 2865 + lvl * 5, 100 + i % 1000);
+        line += buf;
+    }
+    line += "20241111AA";
+    return line; // 186 chars
+}
+
+inline std::string makeTransactionLine(size_t i)
+{
+    char buf[80];
+    std::snprintf(buf, sizeof(buf),
+                  "20241111%04zu  B0%08zu%08zu%05zu0078.35%09zu00000 1",
+                  1000 + i % 2000, 9000000 + i % 1000000, i % 10000000, i % 100000,
+                  1 + i % 1000);
+    std::string line(buf);
+    line.resize(63, ' ');
+    return line;
+}
+
+template <typename Gen>
+std::vector<std::string> makeLines(size_t n, Gen gen)
+{
+    std::vector<std::string> lines;
+    lines.reserve(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        lines.push_back(gen(i));
+    }
+    return lines;
+}
+
+// Write the synthetic lines as a file for the loader benchmarks.
+inline std::string writeLinesFile(const std::vector<std::string> &lines, const char *path)
+{
+    std::ofstream out(path, std::ios::binary);
+    for (const auto &line : lines)
+    {
+        out << line << "\n";
+    }
+    return path;
+}
+
+inline size_t totalBytes(const std::vector<std::string> &lines)
+{
+    return lines.size() * (lines[0].size() + 1);
+}
+
+//------------------------------------------------------------------------------
+// 3. Benchmarks
+//------------------------------------------------------------------------------
+
+int main()
+{
+    constexpr size_t kParseLines = 20000;
+    constexpr size_t kFileLines = 200000;
+
+    auto odr_lines = makeLines(kParseLines, makeOrderLine);
+    auto dsp_lines = makeLines(kParseLines, makeSnapshotLine);
+    auto mth_lines = makeLines(kParseLines, makeTransactionLine);
+
+    // sanity: generators must produce layout-valid lines
+    if (odr_lines[0].size() != 59 || dsp_lines[0].size() != 186 || mth_lines[0].size() != 63)
+    {
+        std::cerr << "generator produced wrong record width\n";
+        return 1;
+    }
+
+    //--- parse kernels ---------------------------------------------------
+
+    runBench("parseOrderLine", totalBytes(odr_lines), [&]() {
+        int sink = 0;
+        for (const auto &line : odr_lines)
+            sink += parseOrderLine(std::string_view(line)).changed_trade_volume;
+        volatile int keep = sink;
+        (void)keep;
+        return odr_lines.size();
+    });
+
+    runBench("parseSnapshotLine", totalBytes(dsp_lines), [&]() {
+        int sink = 0;
+        for (const auto &line : dsp_lines)
+            sink += parseSnapshotLine(std::string_view(line)).transaction_volume;
+        volatile int keep = sink;
+        (void)keep;
+        return dsp_lines.size();
+    });
+
+    runBench("parseTransactionLine", totalBytes(mth_lines), [&]() {
+        int sink = 0;
+        for (const auto &line : mth_lines)
+            sink += parseTransactionLine(std::string_view(line)).trade_volume;
+        volatile int keep = sink;
+        (void)keep;
+        return mth_lines.size();
+    });
+
+    {
+        SymbolTable syms;
+        runBench("parseSnapshotLinePacked", totalBytes(dsp_lines), [&]() {
+            int sink = 0;
+            for (const auto &line : dsp_lines)
+                sink += parseSnapshotLinePacked(std::string_view(line), syms).transaction_volume;
+            volatile int keep = sink;
+            (void)keep;
+            return dsp_lines.size();
+        });
+    }
+
+    //--- loaders ---------------------------------------------------------
+
+    auto dsp_file_lines = makeLines(kFileLines, makeSnapshotLine);
+    std::string dsp_path = writeLinesFile(dsp_file_lines, "/tmp/twse_bench_dsp.txt");
+    size_t dsp_bytes = totalBytes(dsp_file_lines);
+
+    runBench("loadDspFile (ifstream)", dsp_bytes, [&]() {
+        return loadDspFile(dsp_path).size();
+    });
+
+    runBench("loadDspFileMmap", dsp_bytes, [&]() {
+        return loadDspFileMmap(dsp_path).size();
+    });
+
+    runBench("loadDspFileParallel", dsp_bytes, [&]() {
+        return loadDspFileParallel(dsp_path).size();
+    });
+
+    {
+        SymbolTable syms;
+        runBench("loadDspFilePacked", dsp_bytes, [&]() {
+            return loadDspFilePacked(dsp_path, syms).size();
+        });
+    }
+
+    //--- JSON serializers ------------------------------------------------
+
+    auto dsp_records = loadDspFileMmap(dsp_path);
+    dsp_records.resize(kParseLines);
+    size_t dsp_rec_bytes = kParseLines * 187;
+
+    runBench("snapshotToJson (nlohmann)", dsp_rec_bytes, [&]() {
+        size_t sink = 0;
+        for (const auto &snap : dsp_records)
+            sink += snapshotToJson(snap).dump().size();
+        volatile size_t keep = sink;
+        (void)keep;
+        return dsp_records.size();
+    });
+
+    runBench("appendSnapshotJson (direct)", dsp_rec_bytes, [&]() {
+        std::string buf;
+        size_t sink = 0;
+        for (const auto &snap : dsp_records)
+        {
+            buf.clear();
+            appendSnapshotJson(snap, buf);
+            sink += buf.size();
+        }
+        volatile size_t keep = sink;
+        (void)keep;
+        return dsp_records.size();
+    });
+
+    std::remove(dsp_path.c_str());
+    return 0;
+}
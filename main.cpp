@@ -1,89 +1,619 @@
 #include "twse_tick.hpp"
+#include "twse_json.hpp"
+#include "twse_inflate.hpp"
+#include "twse_pipeline.hpp"
+#include "twse_stats.hpp"
+#include "twse_manifest.hpp"
+#include "twse_validate.hpp"
+#include "twse_shm.hpp"
+#include "twse_partition.hpp"
+
+#include <atomic>
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <thread>
+
+//------------------------------------------------------------------------------
+// Batch mode
+//
+//   twse_parser [-j N] --odr PATH... --dsp PATH... --mth PATH...
+//
+// Each PATH is a file or a directory (every regular file inside a directory
+// is taken). Files convert concurrently on a pool of N workers (default:
+// hardware threads, capped at 16 so a year-long run stays well inside the
+// open-file limits documented in FIX_TOO_MANY_OPEN_FILES.md - each worker
+// holds one input and one output open). Output lands next to each input as
+// "<input>.jsonl". With no arguments, the original three-sample-file demo
+// conversion runs.
+//------------------------------------------------------------------------------
 
-int main()
+enum class FileKind
 {
-    try
+    Odr,
+    Dsp,
+    Mth
+};
+
+struct ConvertJob
+{
+    FileKind kind;
+    std::string input;
+    std::string output;
+};
+
+// Single-threaded streaming conversion of one file; cross-file parallelism
+// comes from the worker pool, so per-file we keep exactly two files open.
+// Compressed inputs (.gz/.zst by magic bytes) are inflated on the fly.
+static size_t convertOne(const ConvertJob &job, Manifest *manifest = nullptr)
+{
+    size_t width = (job.kind == FileKind::Odr) ? 59 : (job.kind == FileKind::Dsp) ? 186 : 63;
+
+    // With a manifest, pick up an interrupted conversion at the last
+    // committed offset: truncate the output back to the checkpointed byte
+    // count and skip the records already converted.
+    size_t skip_records = 0;
+    size_t written = 0;
+    if (manifest != nullptr)
+    {
+        ManifestEntry resume = manifest->resumePoint(job.input);
+        if (resume.bytes_done > 0 && std::filesystem::exists(job.output) &&
+            std::filesystem::file_size(job.output) >= resume.bytes_done)
+        {
+            std::filesystem::resize_file(job.output, resume.bytes_done);
+            skip_records = resume.records_done;
+            written = resume.bytes_done;
+        }
+        else
+        {
+            // fresh (re)conversion: pin the input's stat as of right now so
+            // upToDate() matches once this run completes
+            manifest->beginConversion(job.input);
+        }
+    }
+    size_t skip_bytes = written;
+
+    std::ofstream fout(job.output,
+                       skip_records > 0 ? std::ios::binary | std::ios::app : std::ios::binary);
+    if (!fout.is_open())
+    {
+        throw std::runtime_error("Cannot open output file: " + job.output);
+    }
+
+    std::string buf;
+    buf.reserve(1 << 20);
+    size_t count = 0;
+    size_t seen = 0;
+    {
+        // On this path the walk streams straight off the mapping (or the
+        // inflater), so read wait lands in the parse phase; the pipeline
+        // path in twse_pipeline.hpp separates the two.
+        StatsTimer timer(StatsPhase::Parse);
+        forEachRawRecordAuto(job.input, width, [&](std::string_view line) {
+            if (seen++ < skip_records)
+            {
+                count++;
+                return; // already committed by a previous run
+            }
+            switch (job.kind)
+            {
+            case FileKind::Odr:
+                appendOrderJson(parseOrderLine(line), buf);
+                break;
+            case FileKind::Dsp:
+                appendSnapshotJson(parseSnapshotLine(line), buf);
+                break;
+            case FileKind::Mth:
+                appendTransactionJson(parseTransactionLine(line), buf);
+                break;
+            }
+            buf.push_back('\n');
+            count++;
+            if (buf.size() >= (1 << 20))
+            {
+                {
+                    StatsTimer write_timer(StatsPhase::Write);
+                    fout.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+                    fout.flush();
+                }
+                written += buf.size();
+                buf.clear();
+                if (manifest != nullptr)
+                {
+                    manifest->checkpoint(job.input, job.output, count, written, false);
+                }
+            }
+        });
+    }
+    {
+        StatsTimer write_timer(StatsPhase::Write);
+        fout.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        written += buf.size();
+    }
+    if (manifest != nullptr)
+    {
+        manifest->checkpoint(job.input, job.output, count, written, true);
+    }
+    if (RunStats *stats = runStats())
+    {
+        stats->addBytesRead(std::filesystem::file_size(job.input));
+        stats->addBytesWritten(written - skip_bytes);
+        stats->addRecords(count);
+        stats->addFileDone();
+    }
+    return count;
+}
+
+// Expand a file-or-directory argument into jobs, in sorted order so runs are
+// deterministic. Existing .jsonl outputs inside a directory are skipped.
+static void collectJobs(FileKind kind, const std::string &path, std::vector<ConvertJob> &jobs)
+{
+    namespace fs = std::filesystem;
+    if (fs::is_directory(path))
+    {
+        std::vector<std::string> files;
+        for (const auto &entry : fs::directory_iterator(path))
+        {
+            if (entry.is_regular_file() && entry.path().extension() != ".jsonl")
+            {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        for (const auto &f : files)
+        {
+            jobs.push_back({kind, f, f + ".jsonl"});
+        }
+    }
+    else if (fs::is_regular_file(path))
+    {
+        jobs.push_back({kind, path, path + ".jsonl"});
+    }
+    else
+    {
+        throw std::runtime_error("No such file or directory: " + path);
+    }
+}
+
+static int runBatch(const std::vector<ConvertJob> &jobs, unsigned num_workers,
+                    Manifest *manifest = nullptr)
+{
+    if (num_workers == 0)
+    {
+        num_workers = std::thread::hardware_concurrency();
+        if (num_workers == 0)
+        {
+            num_workers = 1;
+        }
+        num_workers = std::min(num_workers, 16u);
+    }
+    num_workers = static_cast<unsigned>(std::min<size_t>(num_workers, jobs.size()));
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> failures{0};
+    std::mutex log_mutex;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < num_workers; t++)
+    {
+        workers.emplace_back([&]() {
+            for (size_t i = next.fetch_add(1); i < jobs.size(); i = next.fetch_add(1))
+            {
+                try
+                {
+                    if (manifest != nullptr && manifest->upToDate(jobs[i].input))
+                    {
+                        std::lock_guard<std::mutex> lock(log_mutex);
+                        std::cout << jobs[i].input << ": up to date, skipped\n";
+                        continue;
+                    }
+                    size_t n = convertOne(jobs[i], manifest);
+                    std::lock_guard<std::mutex> lock(log_mutex);
+                    std::cout << jobs[i].input << " -> " << jobs[i].output
+                              << " (" << n << " records)\n";
+                    if (RunStats *stats = runStats())
+                    {
+                        std::cerr << stats->progressLine() << "\n";
+                    }
+                }
+                catch (const std::exception &ex)
+                {
+                    failures++;
+                    std::lock_guard<std::mutex> lock(log_mutex);
+                    std::cerr << jobs[i].input << ": " << ex.what() << "\n";
+                }
+            }
+        });
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+    return failures.load() == 0 ? 0 : 1;
+}
+
+// Admission gate: scan every input's record geometry without converting
+// anything (twse_validate.hpp). Sequential - the scan is memory-bandwidth
+// bound, so a worker pool would just thrash the page cache.
+static int runValidate(const std::vector<ConvertJob> &jobs)
+{
+    size_t bad_files = 0;
+    for (const ConvertJob &job : jobs)
+    {
+        size_t width = (job.kind == FileKind::Odr) ? 59 : (job.kind == FileKind::Dsp) ? 186 : 63;
+        try
+        {
+            ValidationReport report = validateRecordFile(job.input, width);
+            std::cout << validationSummary(report) << "\n";
+            if (!report.clean())
+            {
+                bad_files++;
+                for (const ValidationIssue &issue : report.issues)
+                {
+                    std::cerr << "  " << job.input << " offset " << issue.offset
+                              << (issue.non_ascii
+                                      ? ": non-ASCII bytes"
+                                      : ": length " + std::to_string(issue.length) +
+                                            " (want " + std::to_string(width) + ")")
+                              << "\n";
+                }
+            }
+        }
+        catch (const std::exception &ex)
+        {
+            bad_files++;
+            std::cerr << job.input << ": " << ex.what() << "\n";
+        }
+    }
+    return bad_files == 0 ? 0 : 1;
+}
+
+// Split the inputs into one JSONL file per securities code under `dir`,
+// during the same single parse pass a normal conversion makes: records are
+// routed by interned symbol id into the PartitionedWriter's per-symbol
+// buffers and drained by its writer pool (twse_partition.hpp). Inputs of
+// different kinds may mix; a symbol's ODR/DSP/MTH records all land in its
+// one file, in input order.
+static int runPartition(const std::vector<ConvertJob> &jobs, const std::string &dir,
+                        unsigned writer_threads)
+{
+    SymbolTable symbols;
+    PartitionedWriter writer(dir, writer_threads == 0 ? 4 : writer_threads);
+    std::string buf;
+    size_t count = 0;
+    for (const ConvertJob &job : jobs)
     {
-        // 1. Load ODR
-        auto odr_records = loadOdrFile("order/odr");
-        std::cout << "Loaded " << odr_records.size() << " ODR records.\n";
-        if (!odr_records.empty())
+        size_t width = (job.kind == FileKind::Odr) ? 59 : (job.kind == FileKind::Dsp) ? 186 : 63;
+        // Symbol column offset in the raw line; route before parsing so the
+        // partition split adds no second scan.
+        size_t code_at = (job.kind == FileKind::Dsp) ? 0 : 8;
+        size_t before = count;
+        StatsTimer timer(StatsPhase::Parse);
+        forEachRawRecordAuto(job.input, width, [&](std::string_view line) {
+            std::string_view code = rStrip(line.substr(code_at, 6));
+            uint32_t id = symbols.intern(code);
+            buf.clear();
+            switch (job.kind)
+            {
+            case FileKind::Odr:
+                appendOrderJson(parseOrderLine(line), buf);
+                break;
+            case FileKind::Dsp:
+                appendSnapshotJson(parseSnapshotLine(line), buf);
+                break;
+            case FileKind::Mth:
+                appendTransactionJson(parseTransactionLine(line), buf);
+                break;
+            }
+            buf.push_back('\n');
+            writer.append(id, code, buf);
+            count++;
+        });
+        if (RunStats *stats = runStats())
         {
-            auto &r = odr_records[0];
-            std::cout << "First ODR record:\n"
-                      << "  order_date=" << r.order_date << "\n"
-                      << "  securities_code=" << r.securities_code << "\n"
-                      << "  buy_sell=" << buySellToString(r.buy_sell) << "\n"
-                      << "  order_price=" << r.order_price << "\n"
-                      << "  changed_trade_volume=" << r.changed_trade_volume << "\n"
-                      << std::endl;
+            stats->addBytesRead(std::filesystem::file_size(job.input));
+            stats->addRecords(count - before);
+            stats->addFileDone();
         }
-        // Option 1: Dump to stdout
-        for (const auto &rec : odr_records)
+    }
+    size_t files = writer.partitionCount();
+    writer.close();
+    std::cout << "Partitioned " << count << " records into " << files
+              << " per-symbol files under " << dir << "\n";
+    return 0;
+}
+
+// Publish the inputs as one packed-record array in a named shared-memory
+// segment (twse_shm.hpp). All inputs must be the same kind - the segment is
+// a single homogeneous array - and the interned symbol table covering every
+// file rides along in the segment.
+static int runShmExport(const std::vector<ConvertJob> &jobs, const std::string &name)
+{
+    for (const ConvertJob &job : jobs)
+    {
+        if (job.kind != jobs.front().kind)
         {
-            nlohmann::json j = orderToJson(rec);
-            std::cout << j.dump() << "\n";
-            // or j.dump(2) for pretty printing, but typically NDJSON is single line
+            throw std::runtime_error("--shm needs inputs of a single kind (--odr/--dsp/--mth)");
         }
-        // Option 2: Dump to a file
-        std::ofstream ofile("order/odr_output.jsonl"); // JSON Lines / NDJSON style
-        for (const auto &rec : odr_records)
+    }
+    SymbolTable symbols;
+    size_t count = 0;
+    switch (jobs.front().kind)
+    {
+    case FileKind::Odr:
+    {
+        std::vector<TwseOrderBookPacked> records;
+        for (const ConvertJob &job : jobs)
         {
-            nlohmann::json j = orderToJson(rec);
-            ofile << j.dump() << "\n";
+            auto part = loadOdrFilePacked(job.input, symbols);
+            records.insert(records.end(), part.begin(), part.end());
         }
-        ofile.close();
+        shmPublish(name, records, symbols);
+        count = records.size();
+        break;
+    }
+    case FileKind::Dsp:
+    {
+        std::vector<TwseSnapshotPacked> records;
+        for (const ConvertJob &job : jobs)
+        {
+            auto part = loadDspFilePacked(job.input, symbols);
+            records.insert(records.end(), part.begin(), part.end());
+        }
+        shmPublish(name, records, symbols);
+        count = records.size();
+        break;
+    }
+    case FileKind::Mth:
+    {
+        std::vector<TwseTransactionPacked> records;
+        for (const ConvertJob &job : jobs)
+        {
+            auto part = loadMthFilePacked(job.input, symbols);
+            records.insert(records.end(), part.begin(), part.end());
+        }
+        shmPublish(name, records, symbols);
+        count = records.size();
+        break;
+    }
+    }
+    std::cout << "Published " << count << " records, " << symbols.size()
+              << " symbols to shm segment " << name << "\n";
+    return 0;
+}
 
-        // 2. Load DSP
-        auto dsp_records = loadDspFile("snapshot/Sample");
-        std::cout << "Loaded " << dsp_records.size() << " DSP records.\n";
-        if (!dsp_records.empty())
+//------------------------------------------------------------------------------
+// Demo mode (original behavior: convert the three sample files)
+//------------------------------------------------------------------------------
+
+// Parse just the first valid line of a file for the preview printout, so the
+// demo output survives without materializing the whole file.
+static bool firstLine(const std::string &filepath, size_t width, std::string &line)
+{
+    std::ifstream fin(filepath, std::ios::binary);
+    while (std::getline(fin, line))
+    {
+        if (line.size() == width)
         {
-            auto &s = dsp_records[0];
-            std::cout << "First DSP record:\n"
-                      << "  securities_code=" << s.securities_code << "\n"
-                      << "  display_time=" << s.display_time << "\n"
-                      << "  match_flag=" << matchFlagToString(s.match_flag) << "\n"
-                      << "  trade_price=" << s.trade_price << "\n"
-                      << "  transaction_volume=" << s.transaction_volume << "\n"
-                      << std::endl;
+            return true;
         }
-        std::ofstream dsp_ofile("snapshot/dsp_output.jsonl");
-        for (const auto &snap : dsp_records)
+    }
+    return false;
+}
+
+static int runDemo()
+{
+    // Each conversion runs as a read / parse / write pipeline
+    // (twse_pipeline.hpp), so disk and CPU overlap instead of
+    // alternating. Output bytes match the old sequential loop exactly.
+
+    // 1. ODR
+    std::string line;
+    if (firstLine("order/odr", 59, line))
+    {
+        TwseOrderBook r = parseOrderLine(line);
+        std::cout << "First ODR record:\n"
+                  << "  order_date=" << r.order_date << "\n"
+                  << "  securities_code=" << r.securities_code << "\n"
+                  << "  buy_sell=" << buySellToString(r.buy_sell) << "\n"
+                  << "  order_price=" << r.order_price << "\n"
+                  << "  changed_trade_volume=" << r.changed_trade_volume << "\n"
+                  << std::endl;
+    }
+    size_t odr_count = convertFilePipelined(
+        "order/odr", "order/odr_output.jsonl", 59,
+        [](std::string_view l, std::string &out) {
+            appendOrderJson(parseOrderLine(l), out);
+            out.push_back('\n');
+        });
+    std::cout << "Converted " << odr_count << " ODR records.\n";
+
+    // 2. DSP
+    if (firstLine("snapshot/Sample", 186, line))
+    {
+        TwseSnapshot s = parseSnapshotLine(line);
+        std::cout << "First DSP record:\n"
+                  << "  securities_code=" << s.securities_code << "\n"
+                  << "  display_time=" << s.display_time << "\n"
+                  << "  match_flag=" << matchFlagToString(s.match_flag) << "\n"
+                  << "  trade_price=" << s.trade_price << "\n"
+                  << "  transaction_volume=" << s.transaction_volume << "\n"
+                  << std::endl;
+    }
+    size_t dsp_count = convertFilePipelined(
+        "snapshot/Sample", "snapshot/dsp_output.jsonl", 186,
+        [](std::string_view l, std::string &out) {
+            appendSnapshotJson(parseSnapshotLine(l), out);
+            out.push_back('\n');
+        });
+    std::cout << "Converted " << dsp_count << " DSP records.\n";
+
+    // 3. MTH
+    if (firstLine("transaction/mth", 63, line))
+    {
+        TwseTransaction t = parseTransactionLine(line);
+        std::cout << "First MTH record:\n"
+                  << "  trade_date=" << t.trade_date << "\n"
+                  << "  securities_code=" << t.securities_code << "\n"
+                  << "  buy_sell=" << buySellToString(t.buy_sell) << "\n"
+                  << "  trade_price=" << t.trade_price << "\n"
+                  << "  trade_volume=" << t.trade_volume << "\n"
+                  << std::endl;
+    }
+    size_t mth_count = convertFilePipelined(
+        "transaction/mth", "transaction/mth_output.jsonl", 63,
+        [](std::string_view l, std::string &out) {
+            appendTransactionJson(parseTransactionLine(l), out);
+            out.push_back('\n');
+        });
+    std::cout << "Converted " << mth_count << " MTH records.\n";
+    return 0;
+}
+
+static void printUsage()
+{
+    std::cout << "Usage: twse_parser [-j N] [--stats] [--validate] [--odr PATH...] [--dsp PATH...] [--mth PATH...]\n"
+                 "  PATH      input file or directory of files (output: <input>.jsonl)\n"
+                 "  -j N      convert up to N files concurrently (default: cores, max 16)\n"
+                 "  --stats   progress lines per file and a JSON run report on stderr\n"
+                 "  --validate\n"
+                 "            scan record geometry only, convert nothing; nonzero exit\n"
+                 "            if any input is malformed\n"
+                 "  --shm /NAME\n"
+                 "            publish the parsed records (one kind only) into a named\n"
+                 "            shared-memory segment instead of converting to JSONL\n"
+                 "  --partition DIR\n"
+                 "            write one JSONL file per securities code under DIR\n"
+                 "            instead of one output per input\n"
+                 "  --manifest FILE\n"
+                 "            checkpoint file: skip unchanged inputs, resume partial ones\n"
+                 "With no arguments, converts the bundled sample files (order/odr,\n"
+                 "snapshot/Sample, transaction/mth) as before.\n";
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        if (argc <= 1)
         {
-            nlohmann::json j = snapshotToJson(snap);
-            dsp_ofile << j.dump() << "\n";
+            return runDemo();
         }
-        dsp_ofile.close();
 
-        // 3. Load MTH
-        auto mth_records = loadMthFile("transaction/mth");
-        std::cout << "Loaded " << mth_records.size() << " MTH records.\n";
-        if (!mth_records.empty())
+        std::vector<ConvertJob> jobs;
+        unsigned num_workers = 0;
+        std::unique_ptr<Manifest> manifest;
+        bool validate_only = false;
+        std::string shm_name;
+        std::string partition_dir;
+        bool have_kind = false;
+        FileKind kind = FileKind::Odr;
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help")
+            {
+                printUsage();
+                return 0;
+            }
+            else if (arg == "--stats")
+            {
+                enableRunStats();
+            }
+            else if (arg == "--validate")
+            {
+                validate_only = true;
+            }
+            else if (arg == "--shm")
+            {
+                if (i + 1 >= argc)
+                {
+                    throw std::runtime_error("--shm requires a segment name");
+                }
+                shm_name = argv[++i];
+            }
+            else if (arg == "--partition")
+            {
+                if (i + 1 >= argc)
+                {
+                    throw std::runtime_error("--partition requires an output directory");
+                }
+                partition_dir = argv[++i];
+            }
+            else if (arg == "--manifest")
+            {
+                if (i + 1 >= argc)
+                {
+                    throw std::runtime_error("--manifest requires a file path");
+                }
+                manifest = std::make_unique<Manifest>(argv[++i]);
+            }
+            else if (arg == "-j")
+            {
+                if (i + 1 >= argc)
+                {
+                    throw std::runtime_error("-j requires a worker count");
+                }
+                num_workers = static_cast<unsigned>(std::atoi(argv[++i]));
+            }
+            else if (arg == "--odr")
+            {
+                kind = FileKind::Odr;
+                have_kind = true;
+            }
+            else if (arg == "--dsp")
+            {
+                kind = FileKind::Dsp;
+                have_kind = true;
+            }
+            else if (arg == "--mth")
+            {
+                kind = FileKind::Mth;
+                have_kind = true;
+            }
+            else if (!have_kind)
+            {
+                throw std::runtime_error("Specify --odr/--dsp/--mth before paths (got: " + arg + ")");
+            }
+            else
+            {
+                collectJobs(kind, arg, jobs);
+            }
+        }
+        if (jobs.empty())
+        {
+            throw std::runtime_error("No input files found.");
+        }
+        if (validate_only)
+        {
+            return runValidate(jobs);
+        }
+        if (!shm_name.empty())
+        {
+            return runShmExport(jobs, shm_name);
+        }
+        if (!partition_dir.empty())
         {
-            auto &t = mth_records[0];
-            std::cout << "First MTH record:\n"
-                      << "  trade_date=" << t.trade_date << "\n"
-                      << "  securities_code=" << t.securities_code << "\n"
-                      << "  buy_sell=" << buySellToString(t.buy_sell) << "\n"
-                      << "  trade_price=" << t.trade_price << "\n"
-                      << "  trade_volume=" << t.trade_volume << "\n"
-                      << std::endl;
+            int rc = runPartition(jobs, partition_dir, num_workers);
+            if (RunStats *stats = runStats())
+            {
+                std::cerr << stats->reportJson() << "\n";
+            }
+            return rc;
         }
-        std::ofstream mth_ofile("transaction/mth_output.jsonl");
-        for (const auto &tx : mth_records)
+        int rc = runBatch(jobs, num_workers, manifest.get());
+        if (RunStats *stats = runStats())
         {
-            nlohmann::json j = transactionToJson(tx);
-            mth_ofile << j.dump() << "\n";
+            std::cerr << stats->reportJson() << "\n";
         }
-        mth_ofile.close();
+        return rc;
     }
     catch (const std::exception &ex)
     {
         std::cerr << "Error: " << ex.what() << std::endl;
+        printUsage();
         return 1;
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,267 @@
+#ifndef TWSE_ARENA_HPP
+#define TWSE_ARENA_HPP
+
+// Arena-backed record loading.
+//
+// Every TwseOrderBook built by parseOrderLine makes up to nine small-string
+// heap allocations, and freeing a 100M-record vector spends tens of seconds
+// in free() alone. The *Arena loaders below land all string payloads for a
+// file in one bump-allocated arena owned by the result set; records hold
+// string_view slices into it. Loading does one arena bump per string instead
+// of a malloc, teardown is a handful of block frees, and the payload bytes
+// sit contiguous in load order, so scans that touch the text fields stay in
+// cache. The numeric fields are identical to the base structs.
+//
+// The views are only valid while the owning result set (its arena) is alive.
+
+#include "twse_mmap.hpp"
+
+#include <memory> // for std::unique_ptr
+
+//------------------------------------------------------------------------------
+// 1. Arena - chunked bump allocator for string payloads
+//------------------------------------------------------------------------------
+
+class Arena
+{
+public:
+    explicit Arena(size_t block_bytes = 1 << 20) : block_bytes_(block_bytes) {}
+
+    // Copy `s` into the arena and return a view of the stored bytes.
+    std::string_view copy(std::string_view s)
+    {
+        // blank fields (a fully stripped code) must not touch blocks_ before
+        // the first block exists
+        if (blocks_.empty() || used_ + s.size() > current_size_)
+        {
+            grow(s.size());
+        }
+        char *dst = blocks_.back().get() + used_;
+        std::memcpy(dst, s.data(), s.size());
+        used_ += s.size();
+        return std::string_view(dst, s.size());
+    }
+
+    size_t bytesUsed() const { return total_used_ + used_; }
+
+private:
+    void grow(size_t need)
+    {
+        size_t size = std::max(block_bytes_, need);
+        blocks_.push_back(std::unique_ptr<char[]>(new char[size]));
+        total_used_ += used_;
+        used_ = 0;
+        current_size_ = size;
+    }
+
+    size_t block_bytes_;
+    size_t current_size_ = 0;
+    size_t used_ = 0;
+    size_t total_used_ = 0;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+};
+
+//------------------------------------------------------------------------------
+// 2. View record structs - same layout as the base structs, string_view text
+//------------------------------------------------------------------------------
+
+struct TwseOrderBookView
+{
+    std::string_view order_date;
+    std::string_view securities_code;
+    uint32_t symbol_id = kNoSymbolId;
+    BuySell buy_sell;
+    int trade_type_code;
+    std::string_view order_time;
+    std::string_view order_number_ii;
+    int changed_trade_code;
+    PriceTicks order_price_ticks;
+    int changed_trade_volume;
+    int order_type_code;
+    std::string_view notes_investors_channel;
+    std::string_view order_report_print;
+    std::string_view type_of_investor;
+    std::string_view order_number_i;
+};
+
+struct TwseSnapshotView
+{
+    std::string_view securities_code;
+    uint32_t symbol_id = kNoSymbolId;
+    std::string_view display_time;
+    std::string_view remark;
+    std::string_view trend_flag;
+    MatchFlag match_flag;
+    std::string_view trade_upper_lower;
+    PriceTicks trade_price_ticks;
+    int transaction_volume;
+    int buy_tick_size;
+    std::string_view buy_upper_lower_limit;
+    std::array<PriceTicks, 5> buy_price_ticks;
+    std::array<int, 5> buy_volumes;
+    int sell_tick_size;
+    std::string_view sell_upper_lower_limit;
+    std::array<PriceTicks, 5> sell_price_ticks;
+    std::array<int, 5> sell_volumes;
+    std::string_view display_date;
+    std::string_view match_staff;
+};
+
+struct TwseTransactionView
+{
+    std::string_view trade_date;
+    std::string_view securities_code;
+    uint32_t symbol_id = kNoSymbolId;
+    BuySell buy_sell;
+    int trade_type_code;
+    std::string_view trade_time;
+    std::string_view trade_number;
+    std::string_view order_number_ii;
+    PriceTicks trade_price_ticks;
+    int trade_volume;
+    std::string_view trading_report;
+    int order_type_code;
+    std::string_view type_of_investor;
+    std::string_view order_number_i;
+};
+
+//------------------------------------------------------------------------------
+// 3. Arena parsers
+//------------------------------------------------------------------------------
+
+inline TwseOrderBookView parseOrderLineArena(std::string_view line, Arena &arena)
+{
+    if (line.size() < 59)
+    {
+        throw std::runtime_error("Line too short (ODR requires 59 chars).");
+    }
+    TwseOrderBookView rec;
+    rec.order_date = arena.copy(line.substr(0, 8));
+    rec.securities_code = arena.copy(rStrip(line.substr(8, 6)));
+    rec.buy_sell = parseBuySell(line[14]);
+    rec.trade_type_code = parseInt(line.substr(15, 1));
+    rec.order_time = arena.copy(line.substr(16, 8));
+    rec.order_number_ii = arena.copy(line.substr(24, 5));
+    rec.changed_trade_code = parseInt(line.substr(29, 1));
+    rec.order_price_ticks = parsePriceTicks(line.substr(30, 7));
+    rec.changed_trade_volume = parseSignAndInt(line.substr(37, 11));
+    rec.order_type_code = parseInt(line.substr(48, 1));
+    rec.notes_investors_channel = arena.copy(line.substr(49, 1));
+    rec.order_report_print = arena.copy(line.substr(50, 4));
+    rec.type_of_investor = arena.copy(line.substr(54, 1));
+    rec.order_number_i = arena.copy(line.substr(55, 4));
+    return rec;
+}
+
+inline TwseSnapshotView parseSnapshotLineArena(std::string_view line, Arena &arena)
+{
+    if (line.size() < 186)
+    {
+        throw std::runtime_error("Line too short (DSP requires 186 chars).");
+    }
+    TwseSnapshotView snap;
+    snap.securities_code = arena.copy(rStrip(line.substr(0, 6)));
+    snap.display_time = arena.copy(line.substr(6, 8));
+    snap.remark = arena.copy(line.substr(14, 1));
+    snap.trend_flag = arena.copy(line.substr(15, 1));
+    snap.match_flag = parseMatchFlag(line[16]);
+    snap.trade_upper_lower = arena.copy(line.substr(17, 1));
+    snap.trade_price_ticks = parse6digitPriceTicks(line.substr(18, 6));
+    snap.transaction_volume = parseInt(line.substr(24, 8));
+    snap.buy_tick_size = parseInt(line.substr(32, 1));
+    snap.buy_upper_lower_limit = arena.copy(line.substr(33, 1));
+    for (int i = 0; i < 5; i++)
+    {
+        size_t offset = 34 + i * 14;
+        snap.buy_price_ticks[i] = parse6digitPriceTicks(line.substr(offset, 6));
+        snap.buy_volumes[i] = parseInt(line.substr(offset + 6, 8));
+    }
+    snap.sell_tick_size = parseInt(line.substr(104, 1));
+    snap.sell_upper_lower_limit = arena.copy(line.substr(105, 1));
+    for (int i = 0; i < 5; i++)
+    {
+        size_t offset = 106 + i * 14;
+        snap.sell_price_ticks[i] = parse6digitPriceTicks(line.substr(offset, 6));
+        snap.sell_volumes[i] = parseInt(line.substr(offset + 6, 8));
+    }
+    snap.display_date = arena.copy(line.substr(176, 8));
+    snap.match_staff = arena.copy(line.substr(184, 2));
+    return snap;
+}
+
+inline TwseTransactionView parseTransactionLineArena(std::string_view line, Arena &arena)
+{
+    if (line.size() < 63)
+    {
+        throw std::runtime_error("Line too short (MTH requires 63 chars).");
+    }
+    TwseTransactionView tx;
+    tx.trade_date = arena.copy(line.substr(0, 8));
+    tx.securities_code = arena.copy(rStrip(line.substr(8, 6)));
+    tx.buy_sell = parseBuySell(line[14]);
+    tx.trade_type_code = parseInt(line.substr(15, 1));
+    tx.trade_time = arena.copy(line.substr(16, 8));
+    tx.trade_number = arena.copy(line.substr(24, 8));
+    tx.order_number_ii = arena.copy(line.substr(32, 5));
+    tx.trade_price_ticks = parsePriceTicks(line.substr(37, 7));
+    tx.trade_volume = parseInt(line.substr(44, 9));
+    tx.trading_report = arena.copy(line.substr(53, 4));
+    tx.order_type_code = parseInt(line.substr(57, 1));
+    tx.type_of_investor = arena.copy(line.substr(58, 1));
+    tx.order_number_i = arena.copy(line.substr(59, 4));
+    return tx;
+}
+
+//------------------------------------------------------------------------------
+// 4. Arena loaders - result set owns the arena the views point into
+//------------------------------------------------------------------------------
+
+struct OdrArenaFile
+{
+    Arena arena;
+    std::vector<TwseOrderBookView> records;
+};
+
+struct DspArenaFile
+{
+    Arena arena;
+    std::vector<TwseSnapshotView> records;
+};
+
+struct MthArenaFile
+{
+    Arena arena;
+    std::vector<TwseTransactionView> records;
+};
+
+inline OdrArenaFile loadOdrFileArena(const std::string &filepath)
+{
+    OdrArenaFile result;
+    MappedFile file(filepath);
+    result.records.reserve(file.size() / 60);
+    forEachRawRecord(file.view(), 59, [&](std::string_view line)
+                     { result.records.push_back(parseOrderLineArena(line, result.arena)); });
+    return result;
+}
+
+inline DspArenaFile loadDspFileArena(const std::string &filepath)
+{
+    DspArenaFile result;
+    MappedFile file(filepath);
+    result.records.reserve(file.size() / 187);
+    forEachRawRecord(file.view(), 186, [&](std::string_view line)
+                     { result.records.push_back(parseSnapshotLineArena(line, result.arena)); });
+    return result;
+}
+
+inline MthArenaFile loadMthFileArena(const std::string &filepath)
+{
+    MthArenaFile result;
+    MappedFile file(filepath);
+    result.records.reserve(file.size() / 64);
+    forEachRawRecord(file.view(), 63, [&](std::string_view line)
+                     { result.records.push_back(parseTransactionLineArena(line, result.arena)); });
+    return result;
+}
+
+#endif // TWSE_ARENA_HPP
@@ -0,0 +1,83 @@
+#ifndef TWSE_ASOF_HPP
+#define TWSE_ASOF_HPP
+
+// As-of join of MTH trades against the prevailing DSP book state.
+//
+// Signal research wants every trade enriched with the five bid/ask levels
+// that were on display when it printed. Doing that through a dataframe
+// merge_asof takes ~20 minutes per day; but both streams already come out
+// of the loaders time-ordered, so the join is a single linear merge: walk
+// trades in order, advance a shared snapshot pointer up to each trade's
+// time while recording the latest snapshot seen per symbol, then attach
+// that symbol's prevailing book to the trade. One pass, no sort, no copy
+// of the snapshot stream.
+//
+// Times compare as the raw fixed-width digit strings (HHMMSSxx), which
+// order lexicographically - no parsing on the hot path.
+
+#include "twse_tick.hpp"
+
+#include <unordered_map>
+
+//------------------------------------------------------------------------------
+// 1. Enriched record
+//------------------------------------------------------------------------------
+
+struct TradeWithBook
+{
+    const TwseTransaction *trade = nullptr;    // into the caller's MTH vector
+    const TwseSnapshot *snapshot = nullptr;    // prevailing book; nullptr if
+                                               // no snapshot preceded the trade
+};
+
+//------------------------------------------------------------------------------
+// 2. Join engine
+//------------------------------------------------------------------------------
+
+// Calls fn(TradeWithBook) once per trade, in trade order. Both inputs must
+// be time-ordered (as the loaders produce them); the result views stay valid
+// as long as the input vectors do.
+template <typename Fn>
+inline void asofJoinTrades(const std::vector<TwseTransaction> &trades,
+                           const std::vector<TwseSnapshot> &snapshots,
+                           Fn &&fn)
+{
+    // Latest snapshot seen so far, per symbol. Keys view into the snapshot
+    // vector's strings, so no per-symbol allocation after the first sighting.
+    std::unordered_map<std::string_view, const TwseSnapshot *> prevailing;
+    prevailing.reserve(1024);
+
+    size_t snap_pos = 0;
+    for (const TwseTransaction &trade : trades)
+    {
+        while (snap_pos < snapshots.size() &&
+               snapshots[snap_pos].display_time <= trade.trade_time)
+        {
+            const TwseSnapshot &snap = snapshots[snap_pos];
+            prevailing[std::string_view(snap.securities_code)] = &snap;
+            snap_pos++;
+        }
+
+        TradeWithBook joined;
+        joined.trade = &trade;
+        auto it = prevailing.find(std::string_view(trade.securities_code));
+        if (it != prevailing.end())
+        {
+            joined.snapshot = it->second;
+        }
+        fn(joined);
+    }
+}
+
+// Materializing convenience for callers that want the whole day joined.
+inline std::vector<TradeWithBook> asofJoinTrades(const std::vector<TwseTransaction> &trades,
+                                                 const std::vector<TwseSnapshot> &snapshots)
+{
+    std::vector<TradeWithBook> joined;
+    joined.reserve(trades.size());
+    asofJoinTrades(trades, snapshots, [&](const TradeWithBook &rec)
+                   { joined.push_back(rec); });
+    return joined;
+}
+
+#endif // TWSE_ASOF_HPP
@@ -0,0 +1,251 @@
+#ifndef TWSE_BARS_HPP
+#define TWSE_BARS_HPP
+
+// Single-pass OHLCV bar aggregation over the MTH trade stream.
+//
+// The daily 1-second and 1-minute bars used to round-trip through
+// mth_output.jsonl into a dataframe - touching two orders of magnitude
+// more bytes than the bars themselves. The aggregator here consumes
+// trades during the load pass (trade_time / trade_price / trade_volume),
+// accumulating into a flat preallocated grid indexed by
+// [symbol id][time bucket], so a day of bars is one linear scan of the
+// raw file with bounded memory: grid rows grow only when a new symbol
+// first trades.
+//
+// The grid covers a configurable session window (default 09:00-14:00,
+// which brackets the TWSE continuous session and the close); trades
+// outside it are counted but not bucketed. writeBarFile emits the
+// non-empty bars as a compact binary ("TWSB") with the symbol codes
+// inline, so downstream jobs never re-derive the interning.
+
+#include "twse_mmap.hpp"
+#include "twse_symbols.hpp"
+
+//------------------------------------------------------------------------------
+// 1. Bar grid
+//------------------------------------------------------------------------------
+
+struct OhlcvBar
+{
+    float open = 0.0f;
+    float high = 0.0f;
+    float low = 0.0f;
+    float close = 0.0f;
+    int64_t volume = 0;
+    uint32_t trade_count = 0; // 0 marks an empty bar
+};
+
+class BarAggregator
+{
+public:
+    // bucket_seconds: 1 for 1s bars, 60 for 1min bars.
+    explicit BarAggregator(uint32_t bucket_seconds,
+                           uint32_t session_start_hhmmss = 90000,
+                           uint32_t session_end_hhmmss = 140000)
+        : bucket_seconds_(bucket_seconds),
+          session_start_(secondsOfDay(session_start_hhmmss)),
+          session_end_(secondsOfDay(session_end_hhmmss))
+    {
+        buckets_ = (session_end_ - session_start_ + bucket_seconds_ - 1) / bucket_seconds_;
+    }
+
+    // time is the raw HHMMSSxx integer the packed loaders carry.
+    void addTrade(uint32_t symbol_id, uint32_t time_hhmmssxx, float price, int32_t volume)
+    {
+        uint32_t sec = secondsOfDay(time_hhmmssxx / 100);
+        if (sec < session_start_ || sec >= session_end_)
+        {
+            out_of_session_++;
+            return;
+        }
+        if (symbol_id >= symbol_count_)
+        {
+            symbol_count_ = symbol_id + 1;
+            grid_.resize(static_cast<size_t>(symbol_count_) * buckets_);
+        }
+        OhlcvBar &bar = grid_[static_cast<size_t>(symbol_id) * buckets_ +
+                              (sec - session_start_) / bucket_seconds_];
+        if (bar.trade_count == 0)
+        {
+            bar.open = bar.high = bar.low = price;
+        }
+        else
+        {
+            bar.high = price > bar.high ? price : bar.high;
+            bar.low = price < bar.low ? price : bar.low;
+        }
+        bar.close = price;
+        bar.volume += volume;
+        bar.trade_count++;
+    }
+
+    void addTrade(const TwseTransaction &trade, uint32_t symbol_id)
+    {
+        addTrade(symbol_id, static_cast<uint32_t>(parseInt(std::string_view(trade.trade_time))),
+                 ticksToPrice(trade.trade_price_ticks), trade.trade_volume);
+    }
+
+    uint32_t bucketSeconds() const { return bucket_seconds_; }
+    uint32_t buckets() const { return buckets_; }
+    uint32_t symbolCount() const { return symbol_count_; }
+    uint64_t outOfSession() const { return out_of_session_; }
+
+    const OhlcvBar &bar(uint32_t symbol_id, uint32_t bucket) const
+    {
+        return grid_[static_cast<size_t>(symbol_id) * buckets_ + bucket];
+    }
+
+    // Start-of-bucket time as HHMMSS, for report/output headers.
+    uint32_t bucketTime(uint32_t bucket) const
+    {
+        uint32_t sec = session_start_ + bucket * bucket_seconds_;
+        return (sec / 3600) * 10000 + ((sec / 60) % 60) * 100 + sec % 60;
+    }
+
+private:
+    static uint32_t secondsOfDay(uint32_t hhmmss)
+    {
+        return (hhmmss / 10000) * 3600 + ((hhmmss / 100) % 100) * 60 + hhmmss % 100;
+    }
+
+    uint32_t bucket_seconds_;
+    uint32_t session_start_; // seconds of day
+    uint32_t session_end_;
+    uint32_t buckets_ = 0;
+    uint32_t symbol_count_ = 0;
+    uint64_t out_of_session_ = 0;
+    std::vector<OhlcvBar> grid_;
+};
+
+//------------------------------------------------------------------------------
+// 2. One-pass file aggregation
+//------------------------------------------------------------------------------
+
+struct MthBarResult
+{
+    SymbolTable symbols;
+    BarAggregator bars;
+};
+
+// Builds bars straight off the raw fixed-width file - no record vector,
+// no intermediate JSON. Decodes only the four fields the bars need.
+inline MthBarResult loadMthFileBars(const std::string &filepath,
+                                    uint32_t bucket_seconds)
+{
+    MthBarResult result{SymbolTable{}, BarAggregator(bucket_seconds)};
+    MappedFile file(filepath);
+    forEachRawRecord(file.view(), 63, [&](std::string_view line) {
+        uint32_t symbol_id = result.symbols.intern(rStrip(line.substr(8, 6)));
+        uint32_t time = static_cast<uint32_t>(parseInt(line.substr(16, 8)));
+        float price = parseFloat(line.substr(37, 7));
+        int32_t volume = parseInt(line.substr(44, 9));
+        result.bars.addTrade(symbol_id, time, price, volume);
+    });
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// 3. Compact bar file ("TWSB"): non-empty bars only, symbol codes inline
+//------------------------------------------------------------------------------
+
+struct BarFileHeader
+{
+    char magic[4]; // "TWSB"
+    uint16_t version;
+    uint16_t pad;
+    uint32_t bucket_seconds;
+    uint32_t symbol_count;
+    uint64_t bar_count;
+};
+static_assert(sizeof(BarFileHeader) == 24, "header must stay 24 bytes");
+
+struct BarFileEntry
+{
+    uint32_t symbol_id;
+    uint32_t time_hhmmss; // bucket start
+    OhlcvBar bar;
+};
+
+inline void writeBarFile(const SymbolTable &symbols, const BarAggregator &bars,
+                         const std::string &filepath)
+{
+    std::ofstream out(filepath, std::ios::binary);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("Cannot open bar output file: " + filepath);
+    }
+
+    uint64_t bar_count = 0;
+    for (uint32_t s = 0; s < bars.symbolCount(); s++)
+    {
+        for (uint32_t b = 0; b < bars.buckets(); b++)
+        {
+            bar_count += bars.bar(s, b).trade_count != 0 ? 1 : 0;
+        }
+    }
+
+    BarFileHeader hdr{};
+    hdr.magic[0] = 'T';
+    hdr.magic[1] = 'W';
+    hdr.magic[2] = 'S';
+    hdr.magic[3] = 'B';
+    hdr.version = 1;
+    hdr.bucket_seconds = bars.bucketSeconds();
+    hdr.symbol_count = static_cast<uint32_t>(symbols.size());
+    hdr.bar_count = bar_count;
+    out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+
+    // Symbol table: 6 space-padded chars per id, in id order.
+    for (uint32_t s = 0; s < symbols.size(); s++)
+    {
+        char code[6] = {' ', ' ', ' ', ' ', ' ', ' '};
+        std::string_view sv = symbols.code(s);
+        std::memcpy(code, sv.data(), std::min<size_t>(sv.size(), 6));
+        out.write(code, 6);
+    }
+
+    for (uint32_t s = 0; s < bars.symbolCount(); s++)
+    {
+        for (uint32_t b = 0; b < bars.buckets(); b++)
+        {
+            const OhlcvBar &bar = bars.bar(s, b);
+            if (bar.trade_count == 0)
+            {
+                continue;
+            }
+            BarFileEntry entry{s, bars.bucketTime(b), bar};
+            out.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        }
+    }
+}
+
+inline std::vector<BarFileEntry> loadBarFile(const std::string &filepath,
+                                             std::vector<std::string> *symbol_codes = nullptr)
+{
+    std::ifstream in(filepath, std::ios::binary);
+    if (!in.is_open())
+    {
+        throw std::runtime_error("Cannot open bar file: " + filepath);
+    }
+    BarFileHeader hdr{};
+    in.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
+    if (std::memcmp(hdr.magic, "TWSB", 4) != 0 || hdr.version != 1)
+    {
+        throw std::runtime_error("Not a TWSB bar file: " + filepath);
+    }
+    for (uint32_t s = 0; s < hdr.symbol_count; s++)
+    {
+        char code[6];
+        in.read(code, 6);
+        if (symbol_codes != nullptr)
+        {
+            symbol_codes->push_back(std::string(rStrip(std::string_view(code, 6))));
+        }
+    }
+    std::vector<BarFileEntry> entries(hdr.bar_count);
+    in.read(reinterpret_cast<char *>(entries.data()),
+            static_cast<std::streamsize>(entries.size() * sizeof(BarFileEntry)));
+    return entries;
+}
+
+#endif // TWSE_BARS_HPP
@@ -0,0 +1,171 @@
+#ifndef TWSE_BOOK_HPP
+#define TWSE_BOOK_HPP
+
+// Limit-order-book reconstruction from the ODR stream.
+//
+// ODR carries everything needed to rebuild per-symbol price-level books:
+// changed_trade_code 1/2/3 is a buy add/adjust/cancel, 4/5/6 the same for
+// sells, and changed_trade_volume's sign already encodes the share delta
+// (negative = cancel or reduce, per the format doc in order/README.md).
+// OrderBookEngine replays events and keeps one book per interned symbol id.
+//
+// Levels are keyed by integer price ticks (hundredths, so exact compares)
+// and live in flat sorted arrays, best price first. After warm-up this does
+// no allocation at all - inserts shift within a vector whose capacity has
+// already peaked - which profiles faster than pooled tree nodes for the few
+// dozen live levels a TWSE book carries, and scans are cache-contiguous.
+// Each applied event can emit a top-of-book update through a callback.
+
+#include "twse_index.hpp" // SymbolTable + RecordSpan
+
+#include <algorithm>  // for std::min
+#include <functional> // for std::function
+
+//------------------------------------------------------------------------------
+// 1. Book structures
+//------------------------------------------------------------------------------
+
+struct BookLevel
+{
+    int32_t price_ticks; // price * 100
+    int64_t volume;      // shares
+};
+
+// One side of a book: levels sorted best-first (descending prices for bids,
+// ascending for asks).
+class BookSide
+{
+public:
+    explicit BookSide(bool is_buy) : is_buy_(is_buy) {}
+
+    // Apply a signed share delta at a price; returns true if the best level
+    // changed. Levels that drop to zero or below are removed.
+    bool apply(int32_t price_ticks, int64_t delta)
+    {
+        auto pos = levels_.begin();
+        while (pos != levels_.end() && better(pos->price_ticks, price_ticks))
+        {
+            ++pos;
+        }
+        bool at_top = (pos == levels_.begin());
+        if (pos != levels_.end() && pos->price_ticks == price_ticks)
+        {
+            pos->volume += delta;
+            if (pos->volume <= 0)
+            {
+                levels_.erase(pos);
+            }
+        }
+        else if (delta > 0)
+        {
+            levels_.insert(pos, {price_ticks, delta});
+        }
+        else
+        {
+            return false; // cancel for a level we never saw (partial-day replay)
+        }
+        return at_top;
+    }
+
+    bool empty() const { return levels_.empty(); }
+    const BookLevel &best() const { return levels_.front(); }
+
+    // Up to n best levels, best first.
+    RecordSpan<BookLevel> top(size_t n) const
+    {
+        return {levels_.data(), std::min(n, levels_.size())};
+    }
+
+private:
+    bool better(int32_t lhs, int32_t rhs) const
+    {
+        return is_buy_ ? lhs > rhs : lhs < rhs;
+    }
+
+    bool is_buy_;
+    std::vector<BookLevel> levels_;
+};
+
+struct SymbolBook
+{
+    SymbolBook() : bids(true), asks(false) {}
+    BookSide bids;
+    BookSide asks;
+};
+
+//------------------------------------------------------------------------------
+// 2. Replay engine
+//------------------------------------------------------------------------------
+
+struct BookUpdate
+{
+    uint32_t symbol_id;
+    uint32_t order_time; // HHMMSSxx as integer
+    const SymbolBook *book;
+};
+
+class OrderBookEngine
+{
+public:
+    explicit OrderBookEngine(SymbolTable &symbols) : symbols_(symbols) {}
+
+    // Apply one ODR event. Returns true if the event touched the top of its
+    // book; when a callback is installed it fires on exactly those events.
+    bool apply(const TwseOrderBook &rec)
+    {
+        uint32_t id = (rec.symbol_id != kNoSymbolId)
+                          ? rec.symbol_id
+                          : symbols_.intern(rec.securities_code);
+        if (id >= books_.size())
+        {
+            // a preassigned rec.symbol_id may come from a table larger than
+            // symbols_, so size to the id itself, not just our own table
+            books_.resize(std::max<size_t>(id + 1, symbols_.size()));
+        }
+        SymbolBook &book = books_[id];
+
+        bool is_buy = rec.changed_trade_code >= 1 && rec.changed_trade_code <= 3;
+        int32_t ticks = rec.order_price_ticks;
+        BookSide &side = is_buy ? book.bids : book.asks;
+        bool top_changed = side.apply(ticks, rec.changed_trade_volume);
+        if (top_changed && on_top_change_)
+        {
+            uint32_t time = static_cast<uint32_t>(parseInt(rec.order_time));
+            on_top_change_(BookUpdate{id, time, &book});
+        }
+        return top_changed;
+    }
+
+    template <typename Fn>
+    void onTopChange(Fn &&fn)
+    {
+        on_top_change_ = std::forward<Fn>(fn);
+    }
+
+    const SymbolBook *bookFor(uint32_t symbol_id) const
+    {
+        return symbol_id < books_.size() ? &books_[symbol_id] : nullptr;
+    }
+
+    size_t bookCount() const { return books_.size(); }
+
+private:
+    SymbolTable &symbols_;
+    std::vector<SymbolBook> books_; // indexed by dense symbol id
+    std::function<void(const BookUpdate &)> on_top_change_;
+};
+
+// Replay a whole ODR file through the engine in one streaming pass.
+// Returns the number of events applied.
+inline size_t replayOdrFile(const std::string &filepath, OrderBookEngine &engine)
+{
+    MappedFile file(filepath);
+    size_t events = 0;
+    forEachRawRecord(file.view(), 59, [&](std::string_view line) {
+        engine.apply(parseOrderLine(line));
+        events++;
+    });
+    return events;
+}
+
+#endif // TWSE_BOOK_HPP
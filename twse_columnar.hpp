@@ -0,0 +1,456 @@
+#ifndef TWSE_COLUMNAR_HPP
+#define TWSE_COLUMNAR_HPP
+
+// Native binary columnar output format ("TWSC").
+//
+// NDJSON inflates a 186-byte DSP record to ~600 bytes of text and has to be
+// re-parsed on every downstream read. This writer lays the parsed records out
+// as structure-of-arrays instead: one contiguous column per field, numeric
+// fields as fixed-size little-endian int32 (prices as PriceTicks hundredth
+// counts since version 2), fixed-width text fields
+// as packed char blocks. The matching loaders mmap the file back and expose
+// zero-copy typed views over the columns, so re-reading a converted day costs
+// a map + pointer fixups instead of a JSON parse.
+//
+// File layout (all columns 8-byte aligned, written in the fixed order the
+// per-format writer/loader pairs below agree on):
+//
+//     [16-byte header] [column 0] [pad] [column 1] [pad] ...
+//
+// The format is intentionally dumb: no compression, no per-column metadata.
+// Schema changes bump kColumnarVersion.
+
+#include "twse_mmap.hpp"
+
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// 1. Header
+//------------------------------------------------------------------------------
+
+enum class ColumnarFormat : uint16_t
+{
+    Odr = 1,
+    Dsp = 2,
+    Mth = 3
+};
+
+constexpr uint16_t kColumnarVersion = 2;
+
+struct ColumnarHeader
+{
+    char magic[4]; // "TWSC"
+    uint16_t version;
+    uint16_t format; // ColumnarFormat
+    uint64_t record_count;
+};
+static_assert(sizeof(ColumnarHeader) == 16, "header must stay 16 bytes");
+
+//------------------------------------------------------------------------------
+// 2. Writer
+//------------------------------------------------------------------------------
+
+class ColumnarWriter
+{
+public:
+    ColumnarWriter(const std::string &filepath, ColumnarFormat format, uint64_t record_count)
+        : out_(filepath, std::ios::binary)
+    {
+        if (!out_.is_open())
+        {
+            throw std::runtime_error("Cannot open columnar output file: " + filepath);
+        }
+        ColumnarHeader hdr{};
+        hdr.magic[0] = 'T';
+        hdr.magic[1] = 'W';
+        hdr.magic[2] = 'S';
+        hdr.magic[3] = 'C';
+        hdr.version = kColumnarVersion;
+        hdr.format = static_cast<uint16_t>(format);
+        hdr.record_count = record_count;
+        writeRaw(&hdr, sizeof(hdr));
+    }
+
+    // Fixed-width text column; shorter values (e.g. rStripped codes) are
+    // space-padded back to the layout width.
+    template <typename Rec, typename Get>
+    void charColumn(const std::vector<Rec> &records, size_t width, Get get)
+    {
+        pad8();
+        std::string cell;
+        for (const auto &rec : records)
+        {
+            cell.assign(get(rec));
+            cell.resize(width, ' ');
+            writeRaw(cell.data(), width);
+        }
+    }
+
+    template <typename Rec, typename Get>
+    void i32Column(const std::vector<Rec> &records, Get get)
+    {
+        pad8();
+        for (const auto &rec : records)
+        {
+            int32_t v = static_cast<int32_t>(get(rec));
+            writeRaw(&v, sizeof(v));
+        }
+    }
+
+    template <typename Rec, typename Get>
+    void f32Column(const std::vector<Rec> &records, Get get)
+    {
+        pad8();
+        for (const auto &rec : records)
+        {
+            float v = get(rec);
+            writeRaw(&v, sizeof(v));
+        }
+    }
+
+    // 5-level array fields (buy_price_ticks etc.) are stored row-major:
+    // record i occupies elements [i*5 .. i*5+4].
+    template <typename Rec, typename Get>
+    void f32x5Column(const std::vector<Rec> &records, Get get)
+    {
+        pad8();
+        for (const auto &rec : records)
+        {
+            const std::array<float, 5> &a = get(rec);
+            writeRaw(a.data(), sizeof(float) * 5);
+        }
+    }
+
+    template <typename Rec, typename Get>
+    void i32x5Column(const std::vector<Rec> &records, Get get)
+    {
+        pad8();
+        for (const auto &rec : records)
+        {
+            const std::array<int, 5> &a = get(rec);
+            for (int v : a)
+            {
+                int32_t v32 = static_cast<int32_t>(v);
+                writeRaw(&v32, sizeof(v32));
+            }
+        }
+    }
+
+private:
+    void writeRaw(const void *p, size_t n)
+    {
+        out_.write(static_cast<const char *>(p), static_cast<std::streamsize>(n));
+        offset_ += n;
+    }
+
+    void pad8()
+    {
+        static const char zeros[8] = {0};
+        size_t rem = offset_ % 8;
+        if (rem != 0)
+        {
+            writeRaw(zeros, 8 - rem);
+        }
+    }
+
+    std::ofstream out_;
+    uint64_t offset_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// 3. Reader cursor
+//------------------------------------------------------------------------------
+
+// Walks the mapped file column by column with the same alignment rule the
+// writer used, handing back typed pointers into the mapping.
+class ColumnarCursor
+{
+public:
+    ColumnarCursor(const MappedFile &file, ColumnarFormat expected_format)
+        : base_(file.data()), size_(file.size())
+    {
+        if (size_ < sizeof(ColumnarHeader))
+        {
+            throw std::runtime_error("Columnar file too small for header.");
+        }
+        ColumnarHeader hdr;
+        std::memcpy(&hdr, base_, sizeof(hdr));
+        if (std::memcmp(hdr.magic, "TWSC", 4) != 0)
+        {
+            throw std::runtime_error("Not a TWSC columnar file (bad magic).");
+        }
+        if (hdr.version != kColumnarVersion)
+        {
+            throw std::runtime_error("Unsupported TWSC version.");
+        }
+        if (hdr.format != static_cast<uint16_t>(expected_format))
+        {
+            throw std::runtime_error("TWSC file holds a different record format.");
+        }
+        count_ = hdr.record_count;
+        offset_ = sizeof(ColumnarHeader);
+    }
+
+    uint64_t count() const { return count_; }
+
+    // Take the next column of `elems_per_record` elements of type T.
+    template <typename T>
+    const T *take(size_t elems_per_record = 1)
+    {
+        offset_ = (offset_ + 7) & ~static_cast<size_t>(7);
+        size_t bytes = sizeof(T) * elems_per_record * count_;
+        if (offset_ + bytes > size_)
+        {
+            throw std::runtime_error("Columnar file truncated.");
+        }
+        const T *p = reinterpret_cast<const T *>(base_ + offset_);
+        offset_ += bytes;
+        return p;
+    }
+
+    // Fixed-width text column: returns the packed char block.
+    const char *takeChars(size_t width)
+    {
+        return take<char>(width);
+    }
+
+private:
+    const char *base_;
+    size_t size_;
+    size_t offset_ = 0;
+    uint64_t count_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// 4. ODR columns
+//------------------------------------------------------------------------------
+
+inline void writeOdrColumnar(const std::vector<TwseOrderBook> &records,
+                             const std::string &filepath)
+{
+    ColumnarWriter w(filepath, ColumnarFormat::Odr, records.size());
+    w.charColumn(records, 8, [](const TwseOrderBook &r) -> const std::string & { return r.order_date; });
+    w.charColumn(records, 6, [](const TwseOrderBook &r) -> const std::string & { return r.securities_code; });
+    w.charColumn(records, 1, [](const TwseOrderBook &r) { return buySellToString(r.buy_sell).substr(0, 1); });
+    w.i32Column(records, [](const TwseOrderBook &r) { return r.trade_type_code; });
+    w.charColumn(records, 8, [](const TwseOrderBook &r) -> const std::string & { return r.order_time; });
+    w.charColumn(records, 5, [](const TwseOrderBook &r) -> const std::string & { return r.order_number_ii; });
+    w.i32Column(records, [](const TwseOrderBook &r) { return r.changed_trade_code; });
+    w.i32Column(records, [](const TwseOrderBook &r) { return r.order_price_ticks; });
+    w.i32Column(records, [](const TwseOrderBook &r) { return r.changed_trade_volume; });
+    w.i32Column(records, [](const TwseOrderBook &r) { return r.order_type_code; });
+    w.charColumn(records, 1, [](const TwseOrderBook &r) -> const std::string & { return r.notes_investors_channel; });
+    w.charColumn(records, 4, [](const TwseOrderBook &r) -> const std::string & { return r.order_report_print; });
+    w.charColumn(records, 1, [](const TwseOrderBook &r) -> const std::string & { return r.type_of_investor; });
+    w.charColumn(records, 4, [](const TwseOrderBook &r) -> const std::string & { return r.order_number_i; });
+}
+
+// Zero-copy view over a mapped ODR columnar file. Pointers stay valid for the
+// lifetime of the struct (it owns the mapping).
+struct OdrColumnar
+{
+    MappedFile file;
+    uint64_t count;
+
+    const char *order_date;      // width 8
+    const char *securities_code; // width 6
+    const char *buy_sell;        // width 1 ('B'/'S'/'U')
+    const int32_t *trade_type_code;
+    const char *order_time;      // width 8
+    const char *order_number_ii; // width 5
+    const int32_t *changed_trade_code;
+    const PriceTicks *order_price_ticks;
+    const int32_t *changed_trade_volume;
+    const int32_t *order_type_code;
+    const char *notes_investors_channel; // width 1
+    const char *order_report_print;      // width 4
+    const char *type_of_investor;        // width 1
+    const char *order_number_i;          // width 4
+
+    std::string_view orderDate(size_t i) const { return {order_date + i * 8, 8}; }
+    std::string_view securitiesCode(size_t i) const { return rStrip(std::string_view(securities_code + i * 6, 6)); }
+};
+
+inline OdrColumnar loadOdrColumnar(const std::string &filepath)
+{
+    OdrColumnar c{MappedFile(filepath), 0, nullptr, nullptr, nullptr, nullptr,
+                  nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                  nullptr, nullptr, nullptr, nullptr};
+    ColumnarCursor cur(c.file, ColumnarFormat::Odr);
+    c.count = cur.count();
+    c.order_date = cur.takeChars(8);
+    c.securities_code = cur.takeChars(6);
+    c.buy_sell = cur.takeChars(1);
+    c.trade_type_code = cur.take<int32_t>();
+    c.order_time = cur.takeChars(8);
+    c.order_number_ii = cur.takeChars(5);
+    c.changed_trade_code = cur.take<int32_t>();
+    c.order_price_ticks = cur.take<PriceTicks>();
+    c.changed_trade_volume = cur.take<int32_t>();
+    c.order_type_code = cur.take<int32_t>();
+    c.notes_investors_channel = cur.takeChars(1);
+    c.order_report_print = cur.takeChars(4);
+    c.type_of_investor = cur.takeChars(1);
+    c.order_number_i = cur.takeChars(4);
+    return c;
+}
+
+//------------------------------------------------------------------------------
+// 5. DSP columns
+//------------------------------------------------------------------------------
+
+inline void writeDspColumnar(const std::vector<TwseSnapshot> &records,
+                             const std::string &filepath)
+{
+    ColumnarWriter w(filepath, ColumnarFormat::Dsp, records.size());
+    w.charColumn(records, 6, [](const TwseSnapshot &r) -> const std::string & { return r.securities_code; });
+    w.charColumn(records, 8, [](const TwseSnapshot &r) -> const std::string & { return r.display_time; });
+    w.charColumn(records, 1, [](const TwseSnapshot &r) -> const std::string & { return r.remark; });
+    w.charColumn(records, 1, [](const TwseSnapshot &r) -> const std::string & { return r.trend_flag; });
+    w.charColumn(records, 1, [](const TwseSnapshot &r) { return matchFlagToString(r.match_flag); });
+    w.charColumn(records, 1, [](const TwseSnapshot &r) -> const std::string & { return r.trade_upper_lower; });
+    w.i32Column(records, [](const TwseSnapshot &r) { return r.trade_price_ticks; });
+    w.i32Column(records, [](const TwseSnapshot &r) { return r.transaction_volume; });
+    w.i32Column(records, [](const TwseSnapshot &r) { return r.buy_tick_size; });
+    w.charColumn(records, 1, [](const TwseSnapshot &r) -> const std::string & { return r.buy_upper_lower_limit; });
+    w.i32x5Column(records, [](const TwseSnapshot &r) -> const std::array<int, 5> & { return r.buy_price_ticks; });
+    w.i32x5Column(records, [](const TwseSnapshot &r) -> const std::array<int, 5> & { return r.buy_volumes; });
+    w.i32Column(records, [](const TwseSnapshot &r) { return r.sell_tick_size; });
+    w.charColumn(records, 1, [](const TwseSnapshot &r) -> const std::string & { return r.sell_upper_lower_limit; });
+    w.i32x5Column(records, [](const TwseSnapshot &r) -> const std::array<int, 5> & { return r.sell_price_ticks; });
+    w.i32x5Column(records, [](const TwseSnapshot &r) -> const std::array<int, 5> & { return r.sell_volumes; });
+    w.charColumn(records, 8, [](const TwseSnapshot &r) -> const std::string & { return r.display_date; });
+    w.charColumn(records, 2, [](const TwseSnapshot &r) -> const std::string & { return r.match_staff; });
+}
+
+struct DspColumnar
+{
+    MappedFile file;
+    uint64_t count;
+
+    const char *securities_code; // width 6
+    const char *display_time;    // width 8
+    const char *remark;          // width 1
+    const char *trend_flag;      // width 1
+    const char *match_flag;      // width 1 (' '/'Y'/'S')
+    const char *trade_upper_lower; // width 1
+    const PriceTicks *trade_price_ticks;
+    const int32_t *transaction_volume;
+    const int32_t *buy_tick_size;
+    const char *buy_upper_lower_limit; // width 1
+    const PriceTicks *buy_price_ticks; // 5 per record, row-major
+    const int32_t *buy_volumes;        // 5 per record, row-major
+    const int32_t *sell_tick_size;
+    const char *sell_upper_lower_limit; // width 1
+    const PriceTicks *sell_price_ticks; // 5 per record, row-major
+    const int32_t *sell_volumes;        // 5 per record, row-major
+    const char *display_date;           // width 8
+    const char *match_staff;            // width 2
+
+    std::string_view securitiesCode(size_t i) const { return rStrip(std::string_view(securities_code + i * 6, 6)); }
+    std::string_view displayTime(size_t i) const { return {display_time + i * 8, 8}; }
+    const PriceTicks *buyPriceTicks(size_t i) const { return buy_price_ticks + i * 5; }
+    const int32_t *buyVolumes(size_t i) const { return buy_volumes + i * 5; }
+    const PriceTicks *sellPriceTicks(size_t i) const { return sell_price_ticks + i * 5; }
+    const int32_t *sellVolumes(size_t i) const { return sell_volumes + i * 5; }
+};
+
+inline DspColumnar loadDspColumnar(const std::string &filepath)
+{
+    DspColumnar c{MappedFile(filepath), 0, nullptr, nullptr, nullptr, nullptr,
+                  nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                  nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                  nullptr, nullptr};
+    ColumnarCursor cur(c.file, ColumnarFormat::Dsp);
+    c.count = cur.count();
+    c.securities_code = cur.takeChars(6);
+    c.display_time = cur.takeChars(8);
+    c.remark = cur.takeChars(1);
+    c.trend_flag = cur.takeChars(1);
+    c.match_flag = cur.takeChars(1);
+    c.trade_upper_lower = cur.takeChars(1);
+    c.trade_price_ticks = cur.take<PriceTicks>();
+    c.transaction_volume = cur.take<int32_t>();
+    c.buy_tick_size = cur.take<int32_t>();
+    c.buy_upper_lower_limit = cur.takeChars(1);
+    c.buy_price_ticks = cur.take<PriceTicks>(5);
+    c.buy_volumes = cur.take<int32_t>(5);
+    c.sell_tick_size = cur.take<int32_t>();
+    c.sell_upper_lower_limit = cur.takeChars(1);
+    c.sell_price_ticks = cur.take<PriceTicks>(5);
+    c.sell_volumes = cur.take<int32_t>(5);
+    c.display_date = cur.takeChars(8);
+    c.match_staff = cur.takeChars(2);
+    return c;
+}
+
+//------------------------------------------------------------------------------
+// 6. MTH columns
+//------------------------------------------------------------------------------
+
+inline void writeMthColumnar(const std::vector<TwseTransaction> &records,
+                             const std::string &filepath)
+{
+    ColumnarWriter w(filepath, ColumnarFormat::Mth, records.size());
+    w.charColumn(records, 8, [](const TwseTransaction &r) -> const std::string & { return r.trade_date; });
+    w.charColumn(records, 6, [](const TwseTransaction &r) -> const std::string & { return r.securities_code; });
+    w.charColumn(records, 1, [](const TwseTransaction &r) { return buySellToString(r.buy_sell).substr(0, 1); });
+    w.i32Column(records, [](const TwseTransaction &r) { return r.trade_type_code; });
+    w.charColumn(records, 8, [](const TwseTransaction &r) -> const std::string & { return r.trade_time; });
+    w.charColumn(records, 8, [](const TwseTransaction &r) -> const std::string & { return r.trade_number; });
+    w.charColumn(records, 5, [](const TwseTransaction &r) -> const std::string & { return r.order_number_ii; });
+    w.i32Column(records, [](const TwseTransaction &r) { return r.trade_price_ticks; });
+    w.i32Column(records, [](const TwseTransaction &r) { return r.trade_volume; });
+    w.charColumn(records, 4, [](const TwseTransaction &r) -> const std::string & { return r.trading_report; });
+    w.i32Column(records, [](const TwseTransaction &r) { return r.order_type_code; });
+    w.charColumn(records, 1, [](const TwseTransaction &r) -> const std::string & { return r.type_of_investor; });
+    w.charColumn(records, 4, [](const TwseTransaction &r) -> const std::string & { return r.order_number_i; });
+}
+
+struct MthColumnar
+{
+    MappedFile file;
+    uint64_t count;
+
+    const char *trade_date;      // width 8
+    const char *securities_code; // width 6
+    const char *buy_sell;        // width 1
+    const int32_t *trade_type_code;
+    const char *trade_time;      // width 8
+    const char *trade_number;    // width 8
+    const char *order_number_ii; // width 5
+    const PriceTicks *trade_price_ticks;
+    const int32_t *trade_volume;
+    const char *trading_report; // width 4
+    const int32_t *order_type_code;
+    const char *type_of_investor; // width 1
+    const char *order_number_i;   // width 4
+
+    std::string_view securitiesCode(size_t i) const { return rStrip(std::string_view(securities_code + i * 6, 6)); }
+    std::string_view tradeTime(size_t i) const { return {trade_time + i * 8, 8}; }
+};
+
+inline MthColumnar loadMthColumnar(const std::string &filepath)
+{
+    MthColumnar c{MappedFile(filepath), 0, nullptr, nullptr, nullptr, nullptr,
+                  nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                  nullptr, nullptr, nullptr};
+    ColumnarCursor cur(c.file, ColumnarFormat::Mth);
+    c.count = cur.count();
+    c.trade_date = cur.takeChars(8);
+    c.securities_code = cur.takeChars(6);
+    c.buy_sell = cur.takeChars(1);
+    c.trade_type_code = cur.take<int32_t>();
+    c.trade_time = cur.takeChars(8);
+    c.trade_number = cur.takeChars(8);
+    c.order_number_ii = cur.takeChars(5);
+    c.trade_price_ticks = cur.take<PriceTicks>();
+    c.trade_volume = cur.take<int32_t>();
+    c.trading_report = cur.takeChars(4);
+    c.order_type_code = cur.take<int32_t>();
+    c.type_of_investor = cur.takeChars(1);
+    c.order_number_i = cur.takeChars(4);
+    return c;
+}
+
+#endif // TWSE_COLUMNAR_HPP
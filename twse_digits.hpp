@@ -0,0 +1,101 @@
+#ifndef TWSE_DIGITS_HPP
+#define TWSE_DIGITS_HPP
+
+// Vectorized decoding of fixed-width ASCII digit runs.
+//
+// The TWSE fields are zero-padded digit runs of known width (6-digit prices,
+// 8-digit volumes, 10-digit signed volumes), which a byte-at-a-time atoi
+// walks one digit per iteration. Here we decode eight digits at once with the
+// SWAR multiply technique used by SIMD JSON parsers: load the run into a
+// 64-bit register, subtract '0' from every byte, then collapse neighbouring
+// digits with three multiply/shift steps. Every field in the three formats
+// fits in one or two such steps (the widest is 10 digits), so an 8-byte
+// kernel already saturates this workload - wider SSE/AVX registers would sit
+// mostly empty. Non-digit input is detected with a SWAR range check and falls
+// back to the caller's scalar path (std::from_chars).
+//
+// The multiply trick assumes little-endian byte order; on other targets the
+// portable loop below is used instead.
+
+#include <cstdint>
+#include <cstring> // for std::memcpy
+#include <string_view>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define TWSE_DIGITS_SWAR 1
+#else
+#define TWSE_DIGITS_SWAR 0
+#endif
+
+// True iff every byte of `chunk` is an ASCII digit ('0'..'9').
+inline bool allDigits8(uint64_t chunk)
+{
+    return (((chunk + 0x4646464646464646ULL) | (chunk - 0x3030303030303030ULL)) &
+            0x8080808080808080ULL) == 0;
+}
+
+// Load up to 8 chars, left-padding with '0' so shorter runs decode to the
+// same value (e.g. "002860" == "00002860").
+inline uint64_t loadDigits8Padded(const char *p, size_t n)
+{
+    char buf[8] = {'0', '0', '0', '0', '0', '0', '0', '0'};
+    std::memcpy(buf + (8 - n), p, n);
+    uint64_t chunk;
+    std::memcpy(&chunk, buf, 8);
+    return chunk;
+}
+
+// Decode 8 ASCII digits held in `chunk` (first digit in the lowest byte on
+// little-endian). Caller has already validated with allDigits8().
+inline uint32_t parseDigits8(uint64_t chunk)
+{
+#if TWSE_DIGITS_SWAR
+    chunk -= 0x3030303030303030ULL;          // ASCII -> digit values
+    chunk = chunk * 10 + (chunk >> 8);       // pairs:   d0*10+d1 per 16 bits
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 100 + (1000000ULL << 32);
+    const uint64_t mul2 = 1 + (10000ULL << 32);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(chunk);
+#else
+    uint32_t value = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        value = value * 10 + static_cast<uint32_t>((chunk >> (i * 8)) & 0xFF) - '0';
+    }
+    return value;
+#endif
+}
+
+// Decode a run of 1..16 ASCII digits into `value`. Returns false - leaving
+// `value` untouched - if the run is empty, too long, or contains a non-digit
+// byte, so the caller can fall back to its scalar parser.
+inline bool parseDigitRun(std::string_view raw, uint64_t &value)
+{
+    size_t n = raw.size();
+    if (n == 0 || n > 16)
+    {
+        return false;
+    }
+    if (n <= 8)
+    {
+        uint64_t chunk = loadDigits8Padded(raw.data(), n);
+        if (!allDigits8(chunk))
+        {
+            return false;
+        }
+        value = parseDigits8(chunk);
+        return true;
+    }
+    uint64_t hi_chunk = loadDigits8Padded(raw.data(), n - 8);
+    uint64_t lo_chunk = loadDigits8Padded(raw.data() + (n - 8), 8);
+    if (!allDigits8(hi_chunk) || !allDigits8(lo_chunk))
+    {
+        return false;
+    }
+    value = static_cast<uint64_t>(parseDigits8(hi_chunk)) * 100000000ULL +
+            parseDigits8(lo_chunk);
+    return true;
+}
+
+#endif // TWSE_DIGITS_HPP
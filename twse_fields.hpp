@@ -0,0 +1,274 @@
+#ifndef TWSE_FIELDS_HPP
+#define TWSE_FIELDS_HPP
+
+// Compile-time field selection for partial parsing.
+//
+// Most analytics jobs read 3-5 fields per record (time, symbol, price,
+// volume), yet the full parsers decode everything - for MTH that is 13
+// fields including text the job discards. parseTransaction<Mask>(line)
+// and its siblings take a bitmask of Fields:: flags as a template
+// argument; every unselected field's decode compiles away (`if constexpr`
+// over the mask), and unselected struct members collapse to an empty tag
+// type. The fixed layout offsets are the same magic numbers the full
+// parsers use, so a narrow query pays only for the bytes it asked for.
+//
+//   auto rec = parseTransaction<Fields::Time | Fields::Price | Fields::Volume>(line);
+//   use(rec.trade_time, rec.trade_price_ticks, rec.trade_volume);
+//
+// Touching an unselected member is a compile error (the tag type has no
+// conversions), so a job can't silently read a field it never decoded.
+// Text fields land as fixed char arrays like the packed structs, so the
+// selected-field parse stays allocation-free.
+
+#include "twse_packed.hpp"
+
+//------------------------------------------------------------------------------
+// 1. Field flags - shared bit names across the three formats
+//------------------------------------------------------------------------------
+
+namespace Fields
+{
+constexpr uint32_t Date = 1u << 0;        // order_date / display_date / trade_date
+constexpr uint32_t Symbol = 1u << 1;      // securities_code
+constexpr uint32_t Time = 1u << 2;        // order_time / display_time / trade_time
+constexpr uint32_t BuySell = 1u << 3;     // ODR & MTH
+constexpr uint32_t Price = 1u << 4;       // order_price_ticks / trade_price_ticks
+constexpr uint32_t Volume = 1u << 5;      // changed_trade_volume / transaction_volume / trade_volume
+constexpr uint32_t TradeType = 1u << 6;   // trade_type_code (ODR & MTH)
+constexpr uint32_t ChangedCode = 1u << 7; // changed_trade_code (ODR)
+constexpr uint32_t OrderType = 1u << 8;   // order_type_code (ODR & MTH)
+constexpr uint32_t Investor = 1u << 9;    // type_of_investor (ODR & MTH)
+constexpr uint32_t OrderNumbers = 1u << 10; // order_number_i / order_number_ii
+constexpr uint32_t MatchFlag = 1u << 11;  // DSP
+constexpr uint32_t Levels = 1u << 12;     // DSP five bid/ask price+volume levels
+
+constexpr uint32_t All = ~0u;
+} // namespace Fields
+
+// Unselected members become this zero-size-ish tag; any use fails to compile.
+struct FieldUnused
+{
+};
+
+template <uint32_t Mask, uint32_t Bit, typename T>
+using FieldIf = std::conditional_t<(Mask & Bit) != 0, T, FieldUnused>;
+
+//------------------------------------------------------------------------------
+// 2. MTH - parseTransaction<Mask>
+//------------------------------------------------------------------------------
+
+template <uint32_t Mask>
+struct TwseTransactionFields
+{
+    FieldIf<Mask, Fields::Date, uint32_t> trade_date;   // YYYYMMDD
+    FieldIf<Mask, Fields::Time, uint32_t> trade_time;   // HHMMSSxx
+    FieldIf<Mask, Fields::Symbol, std::array<char, 6>> securities_code; // space-padded
+    FieldIf<Mask, Fields::BuySell, char> buy_sell;
+    FieldIf<Mask, Fields::TradeType, uint8_t> trade_type_code;
+    FieldIf<Mask, Fields::Price, PriceTicks> trade_price_ticks;
+    FieldIf<Mask, Fields::Volume, int32_t> trade_volume;
+    FieldIf<Mask, Fields::OrderType, uint8_t> order_type_code;
+    FieldIf<Mask, Fields::Investor, char> type_of_investor;
+    FieldIf<Mask, Fields::OrderNumbers, std::array<char, 5>> order_number_ii;
+    FieldIf<Mask, Fields::OrderNumbers, std::array<char, 4>> order_number_i;
+};
+
+template <uint32_t Mask>
+inline TwseTransactionFields<Mask> parseTransaction(std::string_view line)
+{
+    if (line.size() < 63)
+    {
+        throw std::runtime_error("Line too short (MTH requires 63 chars).");
+    }
+    TwseTransactionFields<Mask> rec{};
+    if constexpr ((Mask & Fields::Date) != 0)
+    {
+        rec.trade_date = static_cast<uint32_t>(parseInt(line.substr(0, 8)));
+    }
+    if constexpr ((Mask & Fields::Symbol) != 0)
+    {
+        copyChars(rec.securities_code.data(), line.substr(8, 6));
+    }
+    if constexpr ((Mask & Fields::BuySell) != 0)
+    {
+        rec.buy_sell = line[14];
+    }
+    if constexpr ((Mask & Fields::TradeType) != 0)
+    {
+        rec.trade_type_code = static_cast<uint8_t>(parseInt(line.substr(15, 1)));
+    }
+    if constexpr ((Mask & Fields::Time) != 0)
+    {
+        rec.trade_time = static_cast<uint32_t>(parseInt(line.substr(16, 8)));
+    }
+    if constexpr ((Mask & Fields::OrderNumbers) != 0)
+    {
+        copyChars(rec.order_number_ii.data(), line.substr(32, 5));
+        copyChars(rec.order_number_i.data(), line.substr(59, 4));
+    }
+    if constexpr ((Mask & Fields::Price) != 0)
+    {
+        rec.trade_price_ticks = parsePriceTicks(line.substr(37, 7));
+    }
+    if constexpr ((Mask & Fields::Volume) != 0)
+    {
+        rec.trade_volume = parseInt(line.substr(44, 9));
+    }
+    if constexpr ((Mask & Fields::OrderType) != 0)
+    {
+        rec.order_type_code = static_cast<uint8_t>(parseInt(line.substr(57, 1)));
+    }
+    if constexpr ((Mask & Fields::Investor) != 0)
+    {
+        rec.type_of_investor = line[58];
+    }
+    return rec;
+}
+
+//------------------------------------------------------------------------------
+// 3. ODR - parseOrder<Mask>
+//------------------------------------------------------------------------------
+
+template <uint32_t Mask>
+struct TwseOrderBookFields
+{
+    FieldIf<Mask, Fields::Date, uint32_t> order_date; // YYYYMMDD
+    FieldIf<Mask, Fields::Time, uint32_t> order_time; // HHMMSSxx
+    FieldIf<Mask, Fields::Symbol, std::array<char, 6>> securities_code;
+    FieldIf<Mask, Fields::BuySell, char> buy_sell;
+    FieldIf<Mask, Fields::TradeType, uint8_t> trade_type_code;
+    FieldIf<Mask, Fields::ChangedCode, uint8_t> changed_trade_code;
+    FieldIf<Mask, Fields::Price, PriceTicks> order_price_ticks;
+    FieldIf<Mask, Fields::Volume, int32_t> changed_trade_volume;
+    FieldIf<Mask, Fields::OrderType, uint8_t> order_type_code;
+    FieldIf<Mask, Fields::Investor, char> type_of_investor;
+    FieldIf<Mask, Fields::OrderNumbers, std::array<char, 5>> order_number_ii;
+    FieldIf<Mask, Fields::OrderNumbers, std::array<char, 4>> order_number_i;
+};
+
+template <uint32_t Mask>
+inline TwseOrderBookFields<Mask> parseOrder(std::string_view line)
+{
+    if (line.size() < 59)
+    {
+        throw std::runtime_error("Line too short (ODR requires 59 chars).");
+    }
+    TwseOrderBookFields<Mask> rec{};
+    if constexpr ((Mask & Fields::Date) != 0)
+    {
+        rec.order_date = static_cast<uint32_t>(parseInt(line.substr(0, 8)));
+    }
+    if constexpr ((Mask & Fields::Symbol) != 0)
+    {
+        copyChars(rec.securities_code.data(), line.substr(8, 6));
+    }
+    if constexpr ((Mask & Fields::BuySell) != 0)
+    {
+        rec.buy_sell = line[14];
+    }
+    if constexpr ((Mask & Fields::TradeType) != 0)
+    {
+        rec.trade_type_code = static_cast<uint8_t>(parseInt(line.substr(15, 1)));
+    }
+    if constexpr ((Mask & Fields::Time) != 0)
+    {
+        rec.order_time = static_cast<uint32_t>(parseInt(line.substr(16, 8)));
+    }
+    if constexpr ((Mask & Fields::OrderNumbers) != 0)
+    {
+        copyChars(rec.order_number_ii.data(), line.substr(24, 5));
+        copyChars(rec.order_number_i.data(), line.substr(55, 4));
+    }
+    if constexpr ((Mask & Fields::ChangedCode) != 0)
+    {
+        rec.changed_trade_code = static_cast<uint8_t>(parseInt(line.substr(29, 1)));
+    }
+    if constexpr ((Mask & Fields::Price) != 0)
+    {
+        rec.order_price_ticks = parsePriceTicks(line.substr(30, 7));
+    }
+    if constexpr ((Mask & Fields::Volume) != 0)
+    {
+        rec.changed_trade_volume = parseSignAndInt(line.substr(37, 11));
+    }
+    if constexpr ((Mask & Fields::OrderType) != 0)
+    {
+        rec.order_type_code = static_cast<uint8_t>(parseInt(line.substr(48, 1)));
+    }
+    if constexpr ((Mask & Fields::Investor) != 0)
+    {
+        rec.type_of_investor = line[54];
+    }
+    return rec;
+}
+
+//------------------------------------------------------------------------------
+// 4. DSP - parseSnapshot<Mask>
+//------------------------------------------------------------------------------
+
+template <uint32_t Mask>
+struct TwseSnapshotFields
+{
+    FieldIf<Mask, Fields::Date, uint32_t> display_date; // YYYYMMDD
+    FieldIf<Mask, Fields::Time, uint32_t> display_time; // HHMMSSxx
+    FieldIf<Mask, Fields::Symbol, std::array<char, 6>> securities_code;
+    FieldIf<Mask, Fields::MatchFlag, char> match_flag;
+    FieldIf<Mask, Fields::Price, PriceTicks> trade_price_ticks;
+    FieldIf<Mask, Fields::Volume, int32_t> transaction_volume;
+    FieldIf<Mask, Fields::Levels, std::array<PriceTicks, 5>> buy_price_ticks;
+    FieldIf<Mask, Fields::Levels, std::array<int32_t, 5>> buy_volumes;
+    FieldIf<Mask, Fields::Levels, std::array<PriceTicks, 5>> sell_price_ticks;
+    FieldIf<Mask, Fields::Levels, std::array<int32_t, 5>> sell_volumes;
+};
+
+template <uint32_t Mask>
+inline TwseSnapshotFields<Mask> parseSnapshot(std::string_view line)
+{
+    if (line.size() < 186)
+    {
+        throw std::runtime_error("Line too short (DSP requires 186 chars).");
+    }
+    TwseSnapshotFields<Mask> snap{};
+    if constexpr ((Mask & Fields::Symbol) != 0)
+    {
+        copyChars(snap.securities_code.data(), line.substr(0, 6));
+    }
+    if constexpr ((Mask & Fields::Time) != 0)
+    {
+        snap.display_time = static_cast<uint32_t>(parseInt(line.substr(6, 8)));
+    }
+    if constexpr ((Mask & Fields::MatchFlag) != 0)
+    {
+        snap.match_flag = line[16];
+    }
+    if constexpr ((Mask & Fields::Price) != 0)
+    {
+        snap.trade_price_ticks = parse6digitPriceTicks(line.substr(18, 6));
+    }
+    if constexpr ((Mask & Fields::Volume) != 0)
+    {
+        snap.transaction_volume = parseInt(line.substr(24, 8));
+    }
+    if constexpr ((Mask & Fields::Levels) != 0)
+    {
+        for (int i = 0; i < 5; i++)
+        {
+            size_t offset = 34 + i * 14;
+            snap.buy_price_ticks[i] = parse6digitPriceTicks(line.substr(offset, 6));
+            snap.buy_volumes[i] = parseInt(line.substr(offset + 6, 8));
+        }
+        for (int i = 0; i < 5; i++)
+        {
+            size_t offset = 106 + i * 14;
+            snap.sell_price_ticks[i] = parse6digitPriceTicks(line.substr(offset, 6));
+            snap.sell_volumes[i] = parseInt(line.substr(offset + 6, 8));
+        }
+    }
+    if constexpr ((Mask & Fields::Date) != 0)
+    {
+        snap.display_date = static_cast<uint32_t>(parseInt(line.substr(176, 8)));
+    }
+    return snap;
+}
+
+#endif // TWSE_FIELDS_HPP
@@ -0,0 +1,340 @@
+#ifndef TWSE_FRAMES_HPP
+#define TWSE_FRAMES_HPP
+
+// Seekable compressed archive format ("TWSF") for packed records.
+//
+// The archive tier needs files ~10x smaller than the .jsonl output that
+// still support random access. A TWSF file holds packed records
+// (twse_packed.hpp) in frames of a fixed record count, each frame compressed
+// independently, with a directory in the footer recording every frame's byte
+// offset, record count, and time / symbol-id ranges. A reader seeks the
+// directory, picks the frames a query touches, and decompresses only those -
+// a time-range or symbol load costs a few frames, not the file.
+//
+// Frames compress with zstd when built with -DTWSE_HAVE_ZSTD (and -lzstd);
+// otherwise they are stored raw, which keeps the format and tooling working
+// everywhere while giving up the size win until zstd is available. The codec
+// is recorded per file, so readers handle either.
+//
+// Layout:  [16 B header][frame 0][frame 1]...[directory][24 B trailer]
+
+#include "twse_packed.hpp"
+
+#include <algorithm> // for std::min/std::max
+
+#ifdef TWSE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+//------------------------------------------------------------------------------
+// 1. On-disk structures
+//------------------------------------------------------------------------------
+
+constexpr uint16_t kFrameFormatVersion = 1;
+constexpr size_t kDefaultRecordsPerFrame = 65536;
+
+enum class FrameCodec : uint8_t
+{
+    Store = 0,
+    Zstd = 1
+};
+
+struct FrameFileHeader
+{
+    char magic[4]; // "TWSF"
+    uint16_t version;
+    uint16_t format; // ColumnarFormat tag reused: 1=ODR, 2=DSP, 3=MTH
+    uint8_t codec;   // FrameCodec
+    uint8_t pad[7];
+};
+static_assert(sizeof(FrameFileHeader) == 16, "header must stay 16 bytes");
+
+struct FrameInfo
+{
+    uint64_t byte_offset; // of the compressed frame payload
+    uint32_t comp_bytes;
+    uint32_t record_count;
+    uint32_t time_min; // HHMMSSxx integer range covered by the frame
+    uint32_t time_max;
+    uint32_t symbol_min; // dense symbol-id range
+    uint32_t symbol_max;
+};
+
+struct FrameTrailer
+{
+    uint64_t directory_offset;
+    uint64_t frame_count;
+    char magic[4]; // "TWSF" again, for tail validation
+    char pad[4];
+};
+static_assert(sizeof(FrameTrailer) == 24, "trailer must stay 24 bytes");
+
+//------------------------------------------------------------------------------
+// 2. Writer
+//------------------------------------------------------------------------------
+
+template <typename Rec>
+class FrameWriter
+{
+public:
+    FrameWriter(const std::string &filepath, uint16_t format_tag,
+                size_t records_per_frame = kDefaultRecordsPerFrame)
+        : out_(filepath, std::ios::binary), records_per_frame_(records_per_frame)
+    {
+        if (!out_.is_open())
+        {
+            throw std::runtime_error("Cannot open frame output file: " + filepath);
+        }
+        FrameFileHeader hdr{};
+        hdr.magic[0] = 'T';
+        hdr.magic[1] = 'W';
+        hdr.magic[2] = 'S';
+        hdr.magic[3] = 'F';
+        hdr.version = kFrameFormatVersion;
+        hdr.format = format_tag;
+#ifdef TWSE_HAVE_ZSTD
+        hdr.codec = static_cast<uint8_t>(FrameCodec::Zstd);
+#else
+        hdr.codec = static_cast<uint8_t>(FrameCodec::Store);
+#endif
+        out_.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+        offset_ = sizeof(hdr);
+        buffer_.reserve(records_per_frame_);
+    }
+
+    // `time` and `symbol_id` feed the frame directory's pruning ranges.
+    void add(const Rec &rec, uint32_t time, uint32_t symbol_id)
+    {
+        buffer_.push_back(rec);
+        time_min_ = std::min(time_min_, time);
+        time_max_ = std::max(time_max_, time);
+        symbol_min_ = std::min(symbol_min_, symbol_id);
+        symbol_max_ = std::max(symbol_max_, symbol_id);
+        if (buffer_.size() >= records_per_frame_)
+        {
+            flushFrame();
+        }
+    }
+
+    // Flush the tail frame and write directory + trailer.
+    void finish()
+    {
+        if (!buffer_.empty())
+        {
+            flushFrame();
+        }
+        uint64_t dir_offset = offset_;
+        for (const FrameInfo &f : frames_)
+        {
+            out_.write(reinterpret_cast<const char *>(&f), sizeof(f));
+        }
+        FrameTrailer trailer{};
+        trailer.directory_offset = dir_offset;
+        trailer.frame_count = frames_.size();
+        trailer.magic[0] = 'T';
+        trailer.magic[1] = 'W';
+        trailer.magic[2] = 'S';
+        trailer.magic[3] = 'F';
+        out_.write(reinterpret_cast<const char *>(&trailer), sizeof(trailer));
+        out_.flush();
+    }
+
+private:
+    void flushFrame()
+    {
+        const char *raw = reinterpret_cast<const char *>(buffer_.data());
+        size_t raw_bytes = buffer_.size() * sizeof(Rec);
+        FrameInfo info{};
+        info.byte_offset = offset_;
+        info.record_count = static_cast<uint32_t>(buffer_.size());
+        info.time_min = time_min_;
+        info.time_max = time_max_;
+        info.symbol_min = symbol_min_;
+        info.symbol_max = symbol_max_;
+
+#ifdef TWSE_HAVE_ZSTD
+        comp_buf_.resize(ZSTD_compressBound(raw_bytes));
+        size_t comp = ZSTD_compress(comp_buf_.data(), comp_buf_.size(), raw, raw_bytes, 3);
+        if (ZSTD_isError(comp))
+        {
+            throw std::runtime_error("zstd frame compression failed");
+        }
+        info.comp_bytes = static_cast<uint32_t>(comp);
+        out_.write(comp_buf_.data(), static_cast<std::streamsize>(comp));
+        offset_ += comp;
+#else
+        info.comp_bytes = static_cast<uint32_t>(raw_bytes);
+        out_.write(raw, static_cast<std::streamsize>(raw_bytes));
+        offset_ += raw_bytes;
+#endif
+        frames_.push_back(info);
+        buffer_.clear();
+        time_min_ = 0xFFFFFFFFu;
+        time_max_ = 0;
+        symbol_min_ = 0xFFFFFFFFu;
+        symbol_max_ = 0;
+    }
+
+    std::ofstream out_;
+    size_t records_per_frame_;
+    uint64_t offset_ = 0;
+    std::vector<Rec> buffer_;
+    std::vector<char> comp_buf_;
+    std::vector<FrameInfo> frames_;
+    uint32_t time_min_ = 0xFFFFFFFFu;
+    uint32_t time_max_ = 0;
+    uint32_t symbol_min_ = 0xFFFFFFFFu;
+    uint32_t symbol_max_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// 3. Reader - decompresses only the frames a query touches
+//------------------------------------------------------------------------------
+
+template <typename Rec>
+class FrameReader
+{
+public:
+    FrameReader(const std::string &filepath, uint16_t format_tag)
+        : in_(filepath, std::ios::binary)
+    {
+        if (!in_.is_open())
+        {
+            throw std::runtime_error("Cannot open frame file: " + filepath);
+        }
+        FrameFileHeader hdr{};
+        in_.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
+        if (std::memcmp(hdr.magic, "TWSF", 4) != 0 || hdr.version != kFrameFormatVersion)
+        {
+            throw std::runtime_error("Not a TWSF frame file: " + filepath);
+        }
+        if (hdr.format != format_tag)
+        {
+            throw std::runtime_error("TWSF file holds a different record format: " + filepath);
+        }
+        codec_ = static_cast<FrameCodec>(hdr.codec);
+
+        in_.seekg(-static_cast<std::streamoff>(sizeof(FrameTrailer)), std::ios::end);
+        FrameTrailer trailer{};
+        in_.read(reinterpret_cast<char *>(&trailer), sizeof(trailer));
+        if (std::memcmp(trailer.magic, "TWSF", 4) != 0)
+        {
+            throw std::runtime_error("TWSF trailer corrupt: " + filepath);
+        }
+        frames_.resize(trailer.frame_count);
+        in_.seekg(static_cast<std::streamoff>(trailer.directory_offset));
+        in_.read(reinterpret_cast<char *>(frames_.data()),
+                 static_cast<std::streamsize>(frames_.size() * sizeof(FrameInfo)));
+    }
+
+    const std::vector<FrameInfo> &frames() const { return frames_; }
+
+    std::vector<Rec> readFrame(size_t i)
+    {
+        const FrameInfo &info = frames_.at(i);
+        std::vector<Rec> records(info.record_count);
+        size_t raw_bytes = info.record_count * sizeof(Rec);
+
+        in_.seekg(static_cast<std::streamoff>(info.byte_offset));
+        if (codec_ == FrameCodec::Store)
+        {
+            in_.read(reinterpret_cast<char *>(records.data()),
+                     static_cast<std::streamsize>(raw_bytes));
+        }
+        else
+        {
+#ifdef TWSE_HAVE_ZSTD
+            comp_buf_.resize(info.comp_bytes);
+            in_.read(comp_buf_.data(), static_cast<std::streamsize>(info.comp_bytes));
+            size_t got = ZSTD_decompress(records.data(), raw_bytes,
+                                         comp_buf_.data(), info.comp_bytes);
+            if (ZSTD_isError(got) || got != raw_bytes)
+            {
+                throw std::runtime_error("zstd frame decompression failed");
+            }
+#else
+            throw std::runtime_error("zstd-compressed TWSF needs a build with TWSE_HAVE_ZSTD");
+#endif
+        }
+        return records;
+    }
+
+    // All records from frames overlapping [time_min, time_max] (HHMMSSxx).
+    // Frames are pruned on directory ranges; callers filter record-exact.
+    std::vector<Rec> readTimeRange(uint32_t time_min, uint32_t time_max)
+    {
+        std::vector<Rec> records;
+        for (size_t i = 0; i < frames_.size(); i++)
+        {
+            if (frames_[i].time_max >= time_min && frames_[i].time_min <= time_max)
+            {
+                std::vector<Rec> frame = readFrame(i);
+                records.insert(records.end(), frame.begin(), frame.end());
+            }
+        }
+        return records;
+    }
+
+    // All records from frames whose symbol-id range covers `symbol_id`.
+    std::vector<Rec> readSymbol(uint32_t symbol_id)
+    {
+        std::vector<Rec> records;
+        for (size_t i = 0; i < frames_.size(); i++)
+        {
+            if (frames_[i].symbol_min <= symbol_id && symbol_id <= frames_[i].symbol_max)
+            {
+                std::vector<Rec> frame = readFrame(i);
+                records.insert(records.end(), frame.begin(), frame.end());
+            }
+        }
+        return records;
+    }
+
+private:
+    std::ifstream in_;
+    FrameCodec codec_ = FrameCodec::Store;
+    std::vector<FrameInfo> frames_;
+    std::vector<char> comp_buf_;
+};
+
+//------------------------------------------------------------------------------
+// 4. Convenience writers for whole days
+//------------------------------------------------------------------------------
+
+inline void writeOdrFrames(const std::vector<TwseOrderBookPacked> &records,
+                           const std::string &filepath,
+                           size_t records_per_frame = kDefaultRecordsPerFrame)
+{
+    FrameWriter<TwseOrderBookPacked> w(filepath, 1, records_per_frame);
+    for (const auto &rec : records)
+    {
+        w.add(rec, rec.order_time, rec.symbol_id);
+    }
+    w.finish();
+}
+
+inline void writeDspFrames(const std::vector<TwseSnapshotPacked> &records,
+                           const std::string &filepath,
+                           size_t records_per_frame = kDefaultRecordsPerFrame)
+{
+    FrameWriter<TwseSnapshotPacked> w(filepath, 2, records_per_frame);
+    for (const auto &rec : records)
+    {
+        w.add(rec, rec.display_time, rec.symbol_id);
+    }
+    w.finish();
+}
+
+inline void writeMthFrames(const std::vector<TwseTransactionPacked> &records,
+                           const std::string &filepath,
+                           size_t records_per_frame = kDefaultRecordsPerFrame)
+{
+    FrameWriter<TwseTransactionPacked> w(filepath, 3, records_per_frame);
+    for (const auto &rec : records)
+    {
+        w.add(rec, rec.trade_time, rec.symbol_id);
+    }
+    w.finish();
+}
+
+#endif // TWSE_FRAMES_HPP
@@ -0,0 +1,142 @@
+#ifndef TWSE_INDEX_HPP
+#define TWSE_INDEX_HPP
+
+// Per-symbol index over a loaded record vector.
+//
+// Getting one stock's records out of loadMthFile's result means a full
+// linear scan comparing securities_code strings - repeated thousands of
+// times per research run. SymbolIndex is built in the same pass as parsing:
+// it records, per interned symbol id, the contiguous index runs where that
+// symbol appears in file order. Lookup is one hash probe; the runs are
+// exposed as zero-copy span views over the record vector, so nothing is
+// copied or reordered and time order within a symbol is preserved.
+
+#include "twse_symbols.hpp"
+
+//------------------------------------------------------------------------------
+// 1. Span view (std::span arrives with C++20; this is the subset we need)
+//------------------------------------------------------------------------------
+
+template <typename T>
+struct RecordSpan
+{
+    const T *ptr = nullptr;
+    size_t len = 0;
+
+    const T *begin() const { return ptr; }
+    const T *end() const { return ptr + len; }
+    const T &operator[](size_t i) const { return ptr[i]; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+};
+
+//------------------------------------------------------------------------------
+// 2. SymbolIndex
+//------------------------------------------------------------------------------
+
+struct IndexRange
+{
+    size_t begin;
+    size_t end; // one past the last record index
+};
+
+class SymbolIndex
+{
+public:
+    // Append record `record_index` for `symbol_id`; indices must arrive in
+    // increasing order (they do when called from a load pass). Consecutive
+    // records of the same symbol coalesce into one run.
+    void add(uint32_t symbol_id, size_t record_index)
+    {
+        std::vector<IndexRange> &runs = runs_[symbol_id];
+        if (!runs.empty() && runs.back().end == record_index)
+        {
+            runs.back().end = record_index + 1;
+        }
+        else
+        {
+            runs.push_back({record_index, record_index + 1});
+        }
+    }
+
+    // O(1) lookup; empty for symbols never seen.
+    const std::vector<IndexRange> &rangesFor(uint32_t symbol_id) const
+    {
+        static const std::vector<IndexRange> empty;
+        auto it = runs_.find(symbol_id);
+        return (it != runs_.end()) ? it->second : empty;
+    }
+
+    size_t symbolCount() const { return runs_.size(); }
+
+private:
+    std::unordered_map<uint32_t, std::vector<IndexRange>> runs_;
+};
+
+// Zero-copy views over `records` for one symbol, one span per contiguous run.
+template <typename Rec>
+inline std::vector<RecordSpan<Rec>> spansFor(const std::vector<Rec> &records,
+                                             const SymbolIndex &index,
+                                             uint32_t symbol_id)
+{
+    std::vector<RecordSpan<Rec>> spans;
+    for (const IndexRange &r : index.rangesFor(symbol_id))
+    {
+        spans.push_back({records.data() + r.begin, r.end - r.begin});
+    }
+    return spans;
+}
+
+//------------------------------------------------------------------------------
+// 3. Indexed loaders - parse, intern and index in one pass
+//------------------------------------------------------------------------------
+
+inline std::vector<TwseOrderBook> loadOdrFileIndexed(const std::string &filepath,
+                                                     SymbolTable &symbols,
+                                                     SymbolIndex &index)
+{
+    MappedFile file(filepath);
+    std::vector<TwseOrderBook> records;
+    records.reserve(file.size() / 60);
+    forEachRawRecord(file.view(), 59, [&](std::string_view line)
+                     {
+        records.push_back(parseOrderLine(line));
+        TwseOrderBook &rec = records.back();
+        rec.symbol_id = symbols.intern(rec.securities_code);
+        index.add(rec.symbol_id, records.size() - 1); });
+    return records;
+}
+
+inline std::vector<TwseSnapshot> loadDspFileIndexed(const std::string &filepath,
+                                                    SymbolTable &symbols,
+                                                    SymbolIndex &index)
+{
+    MappedFile file(filepath);
+    std::vector<TwseSnapshot> records;
+    records.reserve(file.size() / 187);
+    forEachRawRecord(file.view(), 186, [&](std::string_view line)
+                     {
+        records.push_back(parseSnapshotLine(line));
+        TwseSnapshot &snap = records.back();
+        snap.symbol_id = symbols.intern(snap.securities_code);
+        index.add(snap.symbol_id, records.size() - 1); });
+    return records;
+}
+
+inline std::vector<TwseTransaction> loadMthFileIndexed(const std::string &filepath,
+                                                       SymbolTable &symbols,
+                                                       SymbolIndex &index)
+{
+    MappedFile file(filepath);
+    std::vector<TwseTransaction> records;
+    records.reserve(file.size() / 64);
+    forEachRawRecord(file.view(), 63, [&](std::string_view line)
+                     {
+        records.push_back(parseTransactionLine(line));
+        TwseTransaction &tx = records.back();
+        tx.symbol_id = symbols.intern(tx.securities_code);
+        index.add(tx.symbol_id, records.size() - 1); });
+    return records;
+}
+
+#endif // TWSE_INDEX_HPP
@@ -0,0 +1,295 @@
+#ifndef TWSE_JSON_HPP
+#define TWSE_JSON_HPP
+
+// Direct-to-buffer NDJSON serializers.
+//
+// orderToJson/snapshotToJson/transactionToJson build a nlohmann::json DOM per
+// record (dozens of node allocations) and then dump() it, and toString2Dec
+// spins up an ostringstream per float field. For 100M-record output that is
+// the dominant cost after parsing. These appenders format each record
+// straight into a caller-owned reusable std::string - key literals are
+// compiled in, floats go through one snprintf("%.2f") - and emit exactly the
+// bytes nlohmann's dump() would (keys in sorted order, no whitespace), so
+// output files are byte-identical either way. The nlohmann converters stay
+// for ad-hoc use.
+//
+// Typical use:
+//     std::string buf;
+//     for (const auto &rec : records)
+//     {
+//         buf.clear();
+//         appendOrderJson(rec, buf);
+//         buf.push_back('\n');
+//         ofile.write(buf.data(), buf.size());
+//     }
+
+#include "twse_tick.hpp"
+
+#include <charconv>
+#include <cstdio> // for std::snprintf
+
+//------------------------------------------------------------------------------
+// 1. Low-level appenders
+//------------------------------------------------------------------------------
+
+// JSON string escaping matching nlohmann's dump(): the TWSE fields are plain
+// ASCII, so this almost always degenerates to a single append.
+inline void appendJsonString(std::string &out, std::string_view s)
+{
+    out.push_back('"');
+    size_t flushed = 0;
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        char c = s[i];
+        const char *esc = nullptr;
+        char ubuf[8];
+        switch (c)
+        {
+        case '"':
+            esc = "\\\"";
+            break;
+        case '\\':
+            esc = "\\\\";
+            break;
+        case '\b':
+            esc = "\\b";
+            break;
+        case '\f':
+            esc = "\\f";
+            break;
+        case '\n':
+            esc = "\\n";
+            break;
+        case '\r':
+            esc = "\\r";
+            break;
+        case '\t':
+            esc = "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                std::snprintf(ubuf, sizeof(ubuf), "\\u%04x", c);
+                esc = ubuf;
+            }
+            break;
+        }
+        if (esc != nullptr)
+        {
+            out.append(s.data() + flushed, i - flushed);
+            out.append(esc);
+            flushed = i + 1;
+        }
+    }
+    out.append(s.data() + flushed, s.size() - flushed);
+    out.push_back('"');
+}
+
+inline void appendInt(std::string &out, long long v)
+{
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr - buf);
+}
+
+// Fixed two-decimal float, same bytes toString2Dec() produces.
+inline void appendFixed2(std::string &out, float x)
+{
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%.2f", static_cast<double>(x));
+    out.append(buf, n);
+}
+
+// "key":"value" / "key":int / "key":"%.2f" - key must already be escaped
+// (all our keys are plain identifiers).
+inline void appendStringField(std::string &out, const char *key, std::string_view value)
+{
+    out.push_back('"');
+    out.append(key);
+    out.append("\":", 2);
+    appendJsonString(out, value);
+}
+
+inline void appendIntField(std::string &out, const char *key, long long value)
+{
+    out.push_back('"');
+    out.append(key);
+    out.append("\":", 2);
+    appendInt(out, value);
+}
+
+inline void appendFixed2Field(std::string &out, const char *key, float value)
+{
+    out.push_back('"');
+    out.append(key);
+    out.append("\":\"", 3);
+    appendFixed2(out, value);
+    out.push_back('"');
+}
+
+// Same two-decimal text straight from a tick count (twse_tick.hpp's
+// PriceTicks) - pure integer formatting, and exact by construction.
+inline void appendTicks2(std::string &out, PriceTicks ticks)
+{
+    if (ticks < 0)
+    {
+        out.push_back('-');
+        ticks = -ticks;
+    }
+    appendInt(out, ticks / 100);
+    out.push_back('.');
+    out.push_back(static_cast<char>('0' + (ticks / 10) % 10));
+    out.push_back(static_cast<char>('0' + ticks % 10));
+}
+
+inline void appendTicksField(std::string &out, const char *key, PriceTicks ticks)
+{
+    out.push_back('"');
+    out.append(key);
+    out.append("\":\"", 3);
+    appendTicks2(out, ticks);
+    out.push_back('"');
+}
+
+//------------------------------------------------------------------------------
+// 2. Per-record serializers
+//
+// Field order below is the keys' alphabetical order, because nlohmann::json
+// stores objects in a sorted map - keep them in sync or the byte-identical
+// guarantee breaks.
+//------------------------------------------------------------------------------
+
+inline void appendOrderJson(const TwseOrderBook &rec, std::string &out)
+{
+    out.push_back('{');
+    appendStringField(out, "buy_sell", buySellToString(rec.buy_sell));
+    out.push_back(',');
+    appendIntField(out, "changed_trade_code", rec.changed_trade_code);
+    out.push_back(',');
+    appendIntField(out, "changed_trade_volume", rec.changed_trade_volume);
+    out.push_back(',');
+    appendStringField(out, "notes_investors_channel", rec.notes_investors_channel);
+    out.push_back(',');
+    appendStringField(out, "order_date", rec.order_date);
+    out.push_back(',');
+    appendStringField(out, "order_number_i", rec.order_number_i);
+    out.push_back(',');
+    appendStringField(out, "order_number_ii", rec.order_number_ii);
+    out.push_back(',');
+    appendTicksField(out, "order_price", rec.order_price_ticks);
+    out.push_back(',');
+    appendStringField(out, "order_report_print", rec.order_report_print);
+    out.push_back(',');
+    appendStringField(out, "order_time", rec.order_time);
+    out.push_back(',');
+    appendIntField(out, "order_type_code", rec.order_type_code);
+    out.push_back(',');
+    appendStringField(out, "securities_code", rec.securities_code);
+    out.push_back(',');
+    appendIntField(out, "trade_type_code", rec.trade_type_code);
+    out.push_back(',');
+    appendStringField(out, "type_of_investor", rec.type_of_investor);
+    out.push_back('}');
+}
+
+inline void appendSnapshotJson(const TwseSnapshot &snap, std::string &out)
+{
+    out.push_back('{');
+    out.append("\"buy_prices\":[");
+    for (int i = 0; i < 5; i++)
+    {
+        if (i > 0)
+            out.push_back(',');
+        out.push_back('"');
+        appendTicks2(out, snap.buy_price_ticks[i]);
+        out.push_back('"');
+    }
+    out.append("],", 2);
+    appendIntField(out, "buy_tick_size", snap.buy_tick_size);
+    out.push_back(',');
+    appendStringField(out, "buy_upper_lower_limit", snap.buy_upper_lower_limit);
+    out.push_back(',');
+    out.append("\"buy_volumes\":[");
+    for (int i = 0; i < 5; i++)
+    {
+        if (i > 0)
+            out.push_back(',');
+        appendInt(out, snap.buy_volumes[i]);
+    }
+    out.append("],", 2);
+    appendStringField(out, "display_date", snap.display_date);
+    out.push_back(',');
+    appendStringField(out, "display_time", snap.display_time);
+    out.push_back(',');
+    appendStringField(out, "match_flag", matchFlagToString(snap.match_flag));
+    out.push_back(',');
+    appendStringField(out, "match_staff", snap.match_staff);
+    out.push_back(',');
+    appendStringField(out, "remark", snap.remark);
+    out.push_back(',');
+    appendStringField(out, "securities_code", snap.securities_code);
+    out.push_back(',');
+    out.append("\"sell_prices\":[");
+    for (int i = 0; i < 5; i++)
+    {
+        if (i > 0)
+            out.push_back(',');
+        out.push_back('"');
+        appendTicks2(out, snap.sell_price_ticks[i]);
+        out.push_back('"');
+    }
+    out.append("],", 2);
+    appendIntField(out, "sell_tick_size", snap.sell_tick_size);
+    out.push_back(',');
+    appendStringField(out, "sell_upper_lower_limit", snap.sell_upper_lower_limit);
+    out.push_back(',');
+    out.append("\"sell_volumes\":[");
+    for (int i = 0; i < 5; i++)
+    {
+        if (i > 0)
+            out.push_back(',');
+        appendInt(out, snap.sell_volumes[i]);
+    }
+    out.append("],", 2);
+    appendTicksField(out, "trade_price", snap.trade_price_ticks);
+    out.push_back(',');
+    appendStringField(out, "trade_upper_lower", snap.trade_upper_lower);
+    out.push_back(',');
+    appendIntField(out, "transaction_volume", snap.transaction_volume);
+    out.push_back(',');
+    appendStringField(out, "trend_flag", snap.trend_flag);
+    out.push_back('}');
+}
+
+inline void appendTransactionJson(const TwseTransaction &tx, std::string &out)
+{
+    out.push_back('{');
+    appendStringField(out, "buy_sell", buySellToString(tx.buy_sell));
+    out.push_back(',');
+    appendStringField(out, "order_number_i", tx.order_number_i);
+    out.push_back(',');
+    appendStringField(out, "order_number_ii", tx.order_number_ii);
+    out.push_back(',');
+    appendIntField(out, "order_type_code", tx.order_type_code);
+    out.push_back(',');
+    appendStringField(out, "securities_code", tx.securities_code);
+    out.push_back(',');
+    appendStringField(out, "trade_date", tx.trade_date);
+    out.push_back(',');
+    appendStringField(out, "trade_number", tx.trade_number);
+    out.push_back(',');
+    appendTicksField(out, "trade_price", tx.trade_price_ticks);
+    out.push_back(',');
+    appendStringField(out, "trade_time", tx.trade_time);
+    out.push_back(',');
+    appendIntField(out, "trade_type_code", tx.trade_type_code);
+    out.push_back(',');
+    appendIntField(out, "trade_volume", tx.trade_volume);
+    out.push_back(',');
+    appendStringField(out, "trading_report", tx.trading_report);
+    out.push_back(',');
+    appendStringField(out, "type_of_investor", tx.type_of_investor);
+    out.push_back('}');
+}
+
+#endif // TWSE_JSON_HPP
@@ -0,0 +1,184 @@
+#ifndef TWSE_MANIFEST_HPP
+#define TWSE_MANIFEST_HPP
+
+// Conversion manifest: skip up-to-date files, resume interrupted ones.
+//
+// The batch mode used to reconvert whole directories because nothing
+// recorded what was already done - a crash at file 240 of 250 meant
+// redoing everything. The manifest is a small tab-separated checkpoint
+// file recording, per input: size and mtime at conversion time, the
+// output path, committed record/byte progress, and completion status.
+// On restart the batch runner skips entries whose input is unchanged and
+// complete, and resumes partial ones at the last committed offset: the
+// output is truncated back to the checkpointed byte count and the input
+// walk skips the records already converted. A re-run over an unchanged
+// archive reduces to stat() calls.
+//
+// Progress is checkpointed at every output flush (~1 MB of JSONL), so at
+// most one flush of work is redone after a crash. The file is rewritten
+// atomically (write tmp + rename) since it is tiny next to the data.
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+// 1. Entries
+//------------------------------------------------------------------------------
+
+struct ManifestEntry
+{
+    std::string input;
+    std::string output;
+    uint64_t input_size = 0;
+    int64_t input_mtime = 0;
+    uint64_t records_done = 0;
+    uint64_t bytes_done = 0; // committed output bytes
+    bool complete = false;
+};
+
+inline bool statInput(const std::string &path, uint64_t &size, int64_t &mtime)
+{
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0)
+    {
+        return false;
+    }
+    size = static_cast<uint64_t>(st.st_size);
+    mtime = static_cast<int64_t>(st.st_mtime);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// 2. Manifest file
+//------------------------------------------------------------------------------
+
+class Manifest
+{
+public:
+    explicit Manifest(const std::string &filepath) : filepath_(filepath)
+    {
+        std::ifstream in(filepath_);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+            std::istringstream fields(line);
+            ManifestEntry e;
+            int complete = 0;
+            std::getline(fields, e.input, '\t');
+            std::getline(fields, e.output, '\t');
+            fields >> e.input_size >> e.input_mtime >> e.records_done >> e.bytes_done >> complete;
+            e.complete = complete != 0;
+            entries_[e.input] = e;
+        }
+    }
+
+    // True when the input was fully converted and hasn't changed since.
+    bool upToDate(const std::string &input) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(input);
+        if (it == entries_.end() || !it->second.complete)
+        {
+            return false;
+        }
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        return statInput(input, size, mtime) &&
+               size == it->second.input_size && mtime == it->second.input_mtime;
+    }
+
+    // Committed progress for a partially-converted, unchanged input;
+    // zeroes when the file must start over (changed, or never seen).
+    ManifestEntry resumePoint(const std::string &input) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ManifestEntry fresh;
+        fresh.input = input;
+        auto it = entries_.find(input);
+        if (it == entries_.end() || it->second.complete)
+        {
+            return fresh;
+        }
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        if (!statInput(input, size, mtime) ||
+            size != it->second.input_size || mtime != it->second.input_mtime)
+        {
+            return fresh; // input changed under us; redo from the start
+        }
+        return it->second;
+    }
+
+    // Record the input's size/mtime as of conversion start and reset any
+    // stale progress. Called before every conversion that is not a resume;
+    // resumed files keep the stat their committed progress came from (which
+    // resumePoint() already verified still matches). Stat-at-start also
+    // means a file modified mid-conversion fails the upToDate() check on
+    // the next run instead of being wrongly skipped.
+    void beginConversion(const std::string &input)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ManifestEntry &e = entries_[input];
+        e.input = input;
+        statInput(input, e.input_size, e.input_mtime);
+        e.records_done = 0;
+        e.bytes_done = 0;
+        e.complete = false;
+        saveLocked();
+    }
+
+    void checkpoint(const std::string &input, const std::string &output,
+                    uint64_t records_done, uint64_t bytes_done, bool complete)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ManifestEntry &e = entries_[input];
+        e.input = input;
+        e.output = output;
+        e.records_done = records_done;
+        e.bytes_done = bytes_done;
+        e.complete = complete;
+        saveLocked();
+    }
+
+private:
+    void saveLocked()
+    {
+        std::string tmp = filepath_ + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            if (!out.is_open())
+            {
+                throw std::runtime_error("Cannot write manifest: " + tmp);
+            }
+            out << "# twse-manifest v1: input output size mtime records bytes complete\n";
+            for (const auto &kv : entries_)
+            {
+                const ManifestEntry &e = kv.second;
+                out << e.input << '\t' << e.output << '\t' << e.input_size << '\t'
+                    << e.input_mtime << '\t' << e.records_done << '\t' << e.bytes_done
+                    << '\t' << (e.complete ? 1 : 0) << '\n';
+            }
+        }
+        if (std::rename(tmp.c_str(), filepath_.c_str()) != 0)
+        {
+            throw std::runtime_error("Cannot replace manifest: " + filepath_);
+        }
+    }
+
+    std::string filepath_;
+    mutable std::mutex mutex_;
+    std::map<std::string, ManifestEntry> entries_;
+};
+
+#endif // TWSE_MANIFEST_HPP
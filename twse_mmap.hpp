@@ -0,0 +1,171 @@
+#ifndef TWSE_MMAP_HPP
+#define TWSE_MMAP_HPP
+
+// Memory-mapped input path for the TWSE fixed-width files.
+//
+// The ifstream loaders in twse_tick.hpp copy every line into a std::string
+// before parsing. For multi-GB daily files that copy (plus getline's buffer
+// management) dominates the I/O layer. Here we map the whole file once and
+// walk the fixed-width records in place, handing std::string_view slices to
+// the string_view parse overloads, so a full-day load does no per-line heap
+// allocation and no buffer copies.
+//
+// Linux/POSIX only (mmap); the portable ifstream loaders remain the fallback.
+
+#include "twse_tick.hpp"
+#include "twse_stats.hpp"
+
+#include <cstddef>
+#include <cstring> // for std::memchr
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// 1. MappedFile - RAII wrapper around open+mmap
+//------------------------------------------------------------------------------
+
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string &filepath)
+    {
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open file: " + filepath);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat file: " + filepath);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0)
+        {
+            void *p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("Cannot mmap file: " + filepath);
+            }
+            data_ = static_cast<const char *>(p);
+            // We always walk the file front to back; let the kernel read ahead.
+            ::madvise(const_cast<char *>(data_), size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd); // mapping stays valid after close
+    }
+
+    ~MappedFile()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<char *>(data_), size_);
+        }
+    }
+
+    // moveable, not copyable (owns the mapping)
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept : data_(other.data_), size_(other.size_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    MappedFile &operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (data_ != nullptr)
+            {
+                ::munmap(const_cast<char *>(data_), size_);
+            }
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    const char *data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// 2. Record walker
+//------------------------------------------------------------------------------
+
+// Walk newline-delimited fixed-width records in a mapped buffer and invoke
+// fn(std::string_view) for each line whose length matches record_width.
+// Lines of any other length are skipped, mirroring the ifstream loaders'
+// `line.size() == N` filter.
+template <typename Fn>
+inline void forEachRawRecord(std::string_view buffer, size_t record_width, Fn &&fn)
+{
+    const char *p = buffer.data();
+    const char *end = p + buffer.size();
+    while (p < end)
+    {
+        const char *nl = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        const char *line_end = (nl != nullptr) ? nl : end;
+        size_t len = static_cast<size_t>(line_end - p);
+        if (len == record_width)
+        {
+            fn(std::string_view(p, len));
+        }
+        else if (RunStats *stats = runStats())
+        {
+            stats->addMalformed(1);
+        }
+        if (nl == nullptr)
+        {
+            break;
+        }
+        p = nl + 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+// 3. mmap-backed loaders (drop-in for loadOdrFile / loadDspFile / loadMthFile)
+//------------------------------------------------------------------------------
+
+inline std::vector<TwseOrderBook> loadOdrFileMmap(const std::string &filepath)
+{
+    MappedFile file(filepath);
+    std::vector<TwseOrderBook> records;
+    records.reserve(file.size() / 60); // 59 chars + newline
+    forEachRawRecord(file.view(), 59, [&](std::string_view line)
+                     { records.push_back(parseOrderLine(line)); });
+    return records;
+}
+
+inline std::vector<TwseSnapshot> loadDspFileMmap(const std::string &filepath)
+{
+    MappedFile file(filepath);
+    std::vector<TwseSnapshot> records;
+    records.reserve(file.size() / 187); // 186 chars + newline
+    forEachRawRecord(file.view(), 186, [&](std::string_view line)
+                     { records.push_back(parseSnapshotLine(line)); });
+    return records;
+}
+
+inline std::vector<TwseTransaction> loadMthFileMmap(const std::string &filepath)
+{
+    MappedFile file(filepath);
+    std::vector<TwseTransaction> records;
+    records.reserve(file.size() / 64); // 63 chars + newline
+    forEachRawRecord(file.view(), 63, [&](std::string_view line)
+                     { records.push_back(parseTransactionLine(line)); });
+    return records;
+}
+
+#endif // TWSE_MMAP_HPP
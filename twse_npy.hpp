@@ -0,0 +1,237 @@
+#ifndef TWSE_NPY_HPP
+#define TWSE_NPY_HPP
+
+// Typed columnar output for Python interop - one .npy file per column.
+//
+// The Python tooling (data.py, data_v2.py, nautilus.py) re-parses either
+// the raw fixed-width files or twse_parser's JSONL in pure Python, which
+// is the slowest stage of the nightly pipeline. The sink here writes each
+// record field as a standard NumPy .npy array inside a "<name>.cols/"
+// directory - numeric fields as little-endian i32/i64/f32, text fields as
+// fixed-width byte strings, the five DSP levels as (n, 5) arrays. NumPy
+// memory-maps .npy natively, so pandas/polars get typed columns with a
+// single zero-copy read per field and no Python-side parsing at all
+// (see twse_npy.py for the loader).
+//
+// This plays the role an Arrow IPC sink would; .npy was chosen because it
+// needs no third-party C++ dependency - the format is a 10-byte magic, a
+// header dict, and the raw little-endian buffer, which is also why the
+// read side is zero-copy.
+
+#include "twse_packed.hpp"
+
+#include <filesystem>
+
+//------------------------------------------------------------------------------
+// 1. .npy writing primitives
+//------------------------------------------------------------------------------
+
+// Writes one array in NPY format v1.0: magic, padded header dict, raw data.
+// `descr` is the NumPy dtype string ('<i4', '<f4', '|S6', ...); cols == 0
+// writes a 1-D array, otherwise shape (rows, cols).
+inline void npyWrite(const std::string &filepath, const char *descr,
+                     size_t rows, size_t cols,
+                     const void *data, size_t bytes)
+{
+    std::ofstream out(filepath, std::ios::binary);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("Cannot open npy output file: " + filepath);
+    }
+
+    std::string shape = cols == 0
+                            ? "(" + std::to_string(rows) + ",)"
+                            : "(" + std::to_string(rows) + ", " + std::to_string(cols) + ")";
+    std::string header = "{'descr': '" + std::string(descr) +
+                         "', 'fortran_order': False, 'shape': " + shape + ", }";
+    // magic(6) + version(2) + header_len(2) + header must be 64-byte aligned
+    size_t unpadded = 10 + header.size() + 1; // +1 for the closing '\n'
+    size_t padded = (unpadded + 63) / 64 * 64;
+    header.append(padded - unpadded, ' ');
+    header.push_back('\n');
+
+    const char magic[8] = {'\x93', 'N', 'U', 'M', 'P', 'Y', '\x01', '\x00'};
+    uint16_t header_len = static_cast<uint16_t>(header.size());
+    out.write(magic, 8);
+    out.write(reinterpret_cast<const char *>(&header_len), 2);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+}
+
+template <typename T>
+inline void npyWriteColumn(const std::string &dir, const std::string &name,
+                           const char *descr, const std::vector<T> &values,
+                           size_t cols = 0)
+{
+    size_t rows = cols == 0 ? values.size() : values.size() / cols;
+    npyWrite(dir + "/" + name + ".npy", descr, rows, cols,
+             values.data(), values.size() * sizeof(T));
+}
+
+// Fixed-width byte-string column (dtype |SN): N bytes per row, 1-D shape.
+inline void npyWriteStrings(const std::string &dir, const std::string &name,
+                            const char *descr, const std::vector<char> &values,
+                            size_t item_bytes)
+{
+    npyWrite(dir + "/" + name + ".npy", descr, values.size() / item_bytes, 0,
+             values.data(), values.size());
+}
+
+//------------------------------------------------------------------------------
+// 2. Column extraction from the packed record vectors
+//------------------------------------------------------------------------------
+
+// Gathers one member across records into a contiguous buffer.
+template <typename Rec, typename T, typename Get>
+inline std::vector<T> gatherColumn(const std::vector<Rec> &records, Get &&get)
+{
+    std::vector<T> values;
+    values.reserve(records.size());
+    for (const Rec &rec : records)
+    {
+        values.push_back(get(rec));
+    }
+    return values;
+}
+
+template <typename Rec, size_t N, typename Get>
+inline std::vector<char> gatherChars(const std::vector<Rec> &records, Get &&get)
+{
+    std::vector<char> values;
+    values.reserve(records.size() * N);
+    for (const Rec &rec : records)
+    {
+        const char *p = get(rec);
+        values.insert(values.end(), p, p + N);
+    }
+    return values;
+}
+
+//------------------------------------------------------------------------------
+// 3. Per-format sinks - "<output_dir>/<field>.npy" per column
+//------------------------------------------------------------------------------
+
+inline void writeMthNpy(const std::vector<TwseTransactionPacked> &records,
+                        const std::string &output_dir)
+{
+    std::filesystem::create_directories(output_dir);
+    npyWriteColumn(output_dir, "trade_date", "<u4",
+                   gatherColumn<TwseTransactionPacked, uint32_t>(records, [](const auto &r) { return r.trade_date; }));
+    npyWriteColumn(output_dir, "trade_time", "<u4",
+                   gatherColumn<TwseTransactionPacked, uint32_t>(records, [](const auto &r) { return r.trade_time; }));
+    npyWriteColumn(output_dir, "symbol_id", "<u4",
+                   gatherColumn<TwseTransactionPacked, uint32_t>(records, [](const auto &r) { return r.symbol_id; }));
+    npyWriteStrings(output_dir, "securities_code", "|S6",
+                   gatherChars<TwseTransactionPacked, 6>(records, [](const auto &r) { return r.securities_code; }), 6);
+    npyWriteColumn(output_dir, "buy_sell", "|S1",
+                   gatherColumn<TwseTransactionPacked, char>(records, [](const auto &r) { return r.buy_sell; }));
+    npyWriteColumn(output_dir, "trade_type_code", "|u1",
+                   gatherColumn<TwseTransactionPacked, uint8_t>(records, [](const auto &r) { return r.trade_type_code; }));
+    npyWriteStrings(output_dir, "trade_number", "|S8",
+                   gatherChars<TwseTransactionPacked, 8>(records, [](const auto &r) { return r.trade_number; }), 8);
+    npyWriteStrings(output_dir, "order_number_ii", "|S5",
+                   gatherChars<TwseTransactionPacked, 5>(records, [](const auto &r) { return r.order_number_ii; }), 5);
+    npyWriteColumn(output_dir, "trade_price_ticks", "<i4",
+                   gatherColumn<TwseTransactionPacked, int32_t>(records, [](const auto &r) { return r.trade_price_ticks; }));
+    npyWriteColumn(output_dir, "trade_volume", "<i4",
+                   gatherColumn<TwseTransactionPacked, int32_t>(records, [](const auto &r) { return r.trade_volume; }));
+    npyWriteStrings(output_dir, "trading_report", "|S4",
+                   gatherChars<TwseTransactionPacked, 4>(records, [](const auto &r) { return r.trading_report; }), 4);
+    npyWriteColumn(output_dir, "order_type_code", "|u1",
+                   gatherColumn<TwseTransactionPacked, uint8_t>(records, [](const auto &r) { return r.order_type_code; }));
+    npyWriteColumn(output_dir, "type_of_investor", "|S1",
+                   gatherColumn<TwseTransactionPacked, char>(records, [](const auto &r) { return r.type_of_investor; }));
+    npyWriteStrings(output_dir, "order_number_i", "|S4",
+                   gatherChars<TwseTransactionPacked, 4>(records, [](const auto &r) { return r.order_number_i; }), 4);
+}
+
+inline void writeOdrNpy(const std::vector<TwseOrderBookPacked> &records,
+                        const std::string &output_dir)
+{
+    std::filesystem::create_directories(output_dir);
+    npyWriteColumn(output_dir, "order_date", "<u4",
+                   gatherColumn<TwseOrderBookPacked, uint32_t>(records, [](const auto &r) { return r.order_date; }));
+    npyWriteColumn(output_dir, "order_time", "<u4",
+                   gatherColumn<TwseOrderBookPacked, uint32_t>(records, [](const auto &r) { return r.order_time; }));
+    npyWriteColumn(output_dir, "symbol_id", "<u4",
+                   gatherColumn<TwseOrderBookPacked, uint32_t>(records, [](const auto &r) { return r.symbol_id; }));
+    npyWriteStrings(output_dir, "securities_code", "|S6",
+                   gatherChars<TwseOrderBookPacked, 6>(records, [](const auto &r) { return r.securities_code; }), 6);
+    npyWriteColumn(output_dir, "buy_sell", "|S1",
+                   gatherColumn<TwseOrderBookPacked, char>(records, [](const auto &r) { return r.buy_sell; }));
+    npyWriteColumn(output_dir, "trade_type_code", "|u1",
+                   gatherColumn<TwseOrderBookPacked, uint8_t>(records, [](const auto &r) { return r.trade_type_code; }));
+    npyWriteStrings(output_dir, "order_number_ii", "|S5",
+                   gatherChars<TwseOrderBookPacked, 5>(records, [](const auto &r) { return r.order_number_ii; }), 5);
+    npyWriteColumn(output_dir, "changed_trade_code", "|u1",
+                   gatherColumn<TwseOrderBookPacked, uint8_t>(records, [](const auto &r) { return r.changed_trade_code; }));
+    npyWriteColumn(output_dir, "order_price_ticks", "<i4",
+                   gatherColumn<TwseOrderBookPacked, int32_t>(records, [](const auto &r) { return r.order_price_ticks; }));
+    npyWriteColumn(output_dir, "changed_trade_volume", "<i4",
+                   gatherColumn<TwseOrderBookPacked, int32_t>(records, [](const auto &r) { return r.changed_trade_volume; }));
+    npyWriteColumn(output_dir, "order_type_code", "|u1",
+                   gatherColumn<TwseOrderBookPacked, uint8_t>(records, [](const auto &r) { return r.order_type_code; }));
+    npyWriteColumn(output_dir, "notes_investors_channel", "|S1",
+                   gatherColumn<TwseOrderBookPacked, char>(records, [](const auto &r) { return r.notes_investors_channel; }));
+    npyWriteStrings(output_dir, "order_report_print", "|S4",
+                   gatherChars<TwseOrderBookPacked, 4>(records, [](const auto &r) { return r.order_report_print; }), 4);
+    npyWriteColumn(output_dir, "type_of_investor", "|S1",
+                   gatherColumn<TwseOrderBookPacked, char>(records, [](const auto &r) { return r.type_of_investor; }));
+    npyWriteStrings(output_dir, "order_number_i", "|S4",
+                   gatherChars<TwseOrderBookPacked, 4>(records, [](const auto &r) { return r.order_number_i; }), 4);
+}
+
+inline void writeDspNpy(const std::vector<TwseSnapshotPacked> &records,
+                        const std::string &output_dir)
+{
+    std::filesystem::create_directories(output_dir);
+    npyWriteColumn(output_dir, "display_date", "<u4",
+                   gatherColumn<TwseSnapshotPacked, uint32_t>(records, [](const auto &r) { return r.display_date; }));
+    npyWriteColumn(output_dir, "display_time", "<u4",
+                   gatherColumn<TwseSnapshotPacked, uint32_t>(records, [](const auto &r) { return r.display_time; }));
+    npyWriteColumn(output_dir, "symbol_id", "<u4",
+                   gatherColumn<TwseSnapshotPacked, uint32_t>(records, [](const auto &r) { return r.symbol_id; }));
+    npyWriteStrings(output_dir, "securities_code", "|S6",
+                   gatherChars<TwseSnapshotPacked, 6>(records, [](const auto &r) { return r.securities_code; }), 6);
+    npyWriteColumn(output_dir, "remark", "|S1",
+                   gatherColumn<TwseSnapshotPacked, char>(records, [](const auto &r) { return r.remark; }));
+    npyWriteColumn(output_dir, "trend_flag", "|S1",
+                   gatherColumn<TwseSnapshotPacked, char>(records, [](const auto &r) { return r.trend_flag; }));
+    npyWriteColumn(output_dir, "match_flag", "|S1",
+                   gatherColumn<TwseSnapshotPacked, char>(records, [](const auto &r) { return r.match_flag; }));
+    npyWriteColumn(output_dir, "trade_upper_lower", "|S1",
+                   gatherColumn<TwseSnapshotPacked, char>(records, [](const auto &r) { return r.trade_upper_lower; }));
+    npyWriteColumn(output_dir, "trade_price_ticks", "<i4",
+                   gatherColumn<TwseSnapshotPacked, int32_t>(records, [](const auto &r) { return r.trade_price_ticks; }));
+    npyWriteColumn(output_dir, "transaction_volume", "<i4",
+                   gatherColumn<TwseSnapshotPacked, int32_t>(records, [](const auto &r) { return r.transaction_volume; }));
+    npyWriteColumn(output_dir, "buy_tick_size", "|u1",
+                   gatherColumn<TwseSnapshotPacked, uint8_t>(records, [](const auto &r) { return r.buy_tick_size; }));
+    npyWriteColumn(output_dir, "sell_tick_size", "|u1",
+                   gatherColumn<TwseSnapshotPacked, uint8_t>(records, [](const auto &r) { return r.sell_tick_size; }));
+
+    // The five levels land as (n, 5) arrays - one mmap each, no reshaping
+    // in Python beyond what numpy's loader already returns.
+    std::vector<int32_t> prices;
+    std::vector<int32_t> volumes;
+    prices.reserve(records.size() * 5);
+    volumes.reserve(records.size() * 5);
+    for (const auto &r : records)
+    {
+        prices.insert(prices.end(), r.buy_price_ticks, r.buy_price_ticks + 5);
+        volumes.insert(volumes.end(), r.buy_volumes, r.buy_volumes + 5);
+    }
+    npyWriteColumn(output_dir, "buy_price_ticks", "<i4", prices, 5);
+    npyWriteColumn(output_dir, "buy_volumes", "<i4", volumes, 5);
+    prices.clear();
+    volumes.clear();
+    for (const auto &r : records)
+    {
+        prices.insert(prices.end(), r.sell_price_ticks, r.sell_price_ticks + 5);
+        volumes.insert(volumes.end(), r.sell_volumes, r.sell_volumes + 5);
+    }
+    npyWriteColumn(output_dir, "sell_price_ticks", "<i4", prices, 5);
+    npyWriteColumn(output_dir, "sell_volumes", "<i4", volumes, 5);
+}
+
+#endif // TWSE_NPY_HPP
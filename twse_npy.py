@@ -0,0 +1,57 @@
+"""Loader for the typed columnar output of twse_npy.hpp.
+
+The C++ side writes each record field as a standard .npy array inside a
+``<name>.cols/`` directory (see twse_npy.hpp). Because .npy is numpy's
+native format, every column loads as a single zero-copy memory map - no
+fixed-width parsing, no JSON decoding, no pandas ``read_*`` round trip.
+
+    >>> cols = load_columns("transaction/mth.cols")
+    >>> cols["trade_price_ticks"]    # memory-mapped int32 array (0.01 units)
+    >>> cols["trade_price_ticks"] / 100.0
+    >>> df = to_pandas("transaction/mth.cols")
+"""
+
+import os
+
+import numpy as np
+
+
+def load_columns(path: str, mmap: bool = True) -> dict:
+    """Return {column_name: numpy array} for every .npy file in `path`.
+
+    With mmap=True (the default) the arrays are memory-mapped, so nothing
+    is read from disk until a column is actually touched.
+    """
+    columns = {}
+    for name in sorted(os.listdir(path)):
+        if name.endswith(".npy"):
+            columns[name[: -len(".npy")]] = np.load(
+                os.path.join(path, name), mmap_mode="r" if mmap else None
+            )
+    return columns
+
+
+def to_pandas(path: str):
+    """Load a column directory into a pandas DataFrame.
+
+    Fixed-width byte-string columns (dtype S*) are decoded to str and
+    right-stripped, matching the rstrip the JSON path applies to
+    securities_code. Two-dimensional level columns (the five DSP bid/ask
+    levels) are expanded to numbered columns, e.g. buy_price_ticks ->
+    buy_price_tick_1..buy_price_tick_5, mirroring the layout in README.md.
+    Price columns are integer tick counts (hundredths); divide by 100 for
+    display prices.
+    """
+    import pandas as pd
+
+    frame = {}
+    for name, arr in load_columns(path).items():
+        if arr.ndim == 2:
+            stem = name[:-1] if name.endswith("s") else name
+            for i in range(arr.shape[1]):
+                frame["%s_%d" % (stem, i + 1)] = arr[:, i]
+        elif arr.dtype.kind == "S":
+            frame[name] = np.char.rstrip(arr.astype(str))
+        else:
+            frame[name] = arr
+    return pd.DataFrame(frame)
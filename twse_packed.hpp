@@ -0,0 +1,232 @@
+#ifndef TWSE_PACKED_HPP
+#define TWSE_PACKED_HPP
+
+// Packed POD record variants for scan-heavy analytics.
+//
+// The string-bearing structs in twse_tick.hpp cost 400+ bytes per record once
+// the eight std::string heap blocks are counted, so scans over a day's vector
+// are memory-bandwidth bound on pointer-chased data. The *Packed variants
+// below are trivially copyable, fit in one or two cache lines, and hold:
+//
+//   - fixed char[N] arrays for the raw text fields (space-padded, no rstrip),
+//   - dates/times as integers (YYYYMMDD / HHMMSSxx digit values),
+//   - prices as exact PriceTicks hundredth counts (no float in the record),
+//   - the interned symbol id from twse_symbols.hpp.
+//
+// They are parsed straight from the fixed-width line, never via the string
+// structs, so the packed loaders also skip every per-record allocation.
+
+#include "twse_symbols.hpp"
+
+#include <type_traits>
+
+//------------------------------------------------------------------------------
+// 1. Packed structs
+//------------------------------------------------------------------------------
+
+struct TwseOrderBookPacked
+{
+    uint32_t order_date; // YYYYMMDD as integer
+    uint32_t symbol_id;
+    uint32_t order_time;         // HHMMSSxx as integer
+    char securities_code[6];     // space-padded
+    char buy_sell;               // 'B'/'S'
+    uint8_t trade_type_code;
+    char order_number_ii[5];
+    uint8_t changed_trade_code;
+    PriceTicks order_price_ticks;
+    int32_t changed_trade_volume;
+    uint8_t order_type_code;
+    char notes_investors_channel;
+    char order_report_print[4];
+    char type_of_investor;
+    char order_number_i[4];
+
+    std::string_view securitiesCode() const { return rStrip(std::string_view(securities_code, 6)); }
+};
+
+struct TwseSnapshotPacked
+{
+    uint32_t symbol_id;
+    uint32_t display_time; // HHMMSSxx as integer
+    uint32_t display_date; // YYYYMMDD as integer
+    char securities_code[6];
+    char remark;
+    char trend_flag;
+    char match_flag; // ' '/'Y'/'S'
+    char trade_upper_lower;
+    PriceTicks trade_price_ticks;
+    int32_t transaction_volume;
+    uint8_t buy_tick_size;
+    char buy_upper_lower_limit;
+    uint8_t sell_tick_size;
+    char sell_upper_lower_limit;
+    char match_staff[2];
+    PriceTicks buy_price_ticks[5];
+    int32_t buy_volumes[5];
+    PriceTicks sell_price_ticks[5];
+    int32_t sell_volumes[5];
+
+    std::string_view securitiesCode() const { return rStrip(std::string_view(securities_code, 6)); }
+};
+
+struct TwseTransactionPacked
+{
+    uint32_t trade_date; // YYYYMMDD as integer
+    uint32_t symbol_id;
+    uint32_t trade_time; // HHMMSSxx as integer
+    char securities_code[6];
+    char buy_sell;
+    uint8_t trade_type_code;
+    char trade_number[8];
+    char order_number_ii[5];
+    uint8_t order_type_code;
+    PriceTicks trade_price_ticks;
+    int32_t trade_volume;
+    char trading_report[4];
+    char type_of_investor;
+    char order_number_i[4];
+
+    std::string_view securitiesCode() const { return rStrip(std::string_view(securities_code, 6)); }
+};
+
+static_assert(std::is_trivially_copyable<TwseOrderBookPacked>::value, "must stay POD");
+static_assert(std::is_trivially_copyable<TwseSnapshotPacked>::value, "must stay POD");
+static_assert(std::is_trivially_copyable<TwseTransactionPacked>::value, "must stay POD");
+static_assert(sizeof(TwseOrderBookPacked) <= 64, "one cache line");
+static_assert(sizeof(TwseSnapshotPacked) <= 128, "two cache lines");
+static_assert(sizeof(TwseTransactionPacked) <= 64, "one cache line");
+
+//------------------------------------------------------------------------------
+// 2. Packed line parsers
+//------------------------------------------------------------------------------
+
+inline void copyChars(char *dst, std::string_view src)
+{
+    std::memcpy(dst, src.data(), src.size());
+}
+
+inline TwseOrderBookPacked parseOrderLinePacked(std::string_view line, SymbolTable &symbols)
+{
+    if (line.size() < 59)
+    {
+        throw std::runtime_error("Line too short (ODR requires 59 chars).");
+    }
+    TwseOrderBookPacked rec{};
+    rec.order_date = static_cast<uint32_t>(parseInt(line.substr(0, 8)));
+    copyChars(rec.securities_code, line.substr(8, 6));
+    rec.symbol_id = symbols.intern(rStrip(line.substr(8, 6)));
+    rec.buy_sell = line[14];
+    rec.trade_type_code = static_cast<uint8_t>(parseInt(line.substr(15, 1)));
+    rec.order_time = static_cast<uint32_t>(parseInt(line.substr(16, 8)));
+    copyChars(rec.order_number_ii, line.substr(24, 5));
+    rec.changed_trade_code = static_cast<uint8_t>(parseInt(line.substr(29, 1)));
+    rec.order_price_ticks = parsePriceTicks(line.substr(30, 7));
+    rec.changed_trade_volume = parseSignAndInt(line.substr(37, 11));
+    rec.order_type_code = static_cast<uint8_t>(parseInt(line.substr(48, 1)));
+    rec.notes_investors_channel = line[49];
+    copyChars(rec.order_report_print, line.substr(50, 4));
+    rec.type_of_investor = line[54];
+    copyChars(rec.order_number_i, line.substr(55, 4));
+    return rec;
+}
+
+inline TwseSnapshotPacked parseSnapshotLinePacked(std::string_view line, SymbolTable &symbols)
+{
+    if (line.size() < 186)
+    {
+        throw std::runtime_error("Line too short (DSP requires 186 chars).");
+    }
+    TwseSnapshotPacked snap{};
+    copyChars(snap.securities_code, line.substr(0, 6));
+    snap.symbol_id = symbols.intern(rStrip(line.substr(0, 6)));
+    snap.display_time = static_cast<uint32_t>(parseInt(line.substr(6, 8)));
+    snap.remark = line[14];
+    snap.trend_flag = line[15];
+    snap.match_flag = line[16];
+    snap.trade_upper_lower = line[17];
+    snap.trade_price_ticks = parse6digitPriceTicks(line.substr(18, 6));
+    snap.transaction_volume = parseInt(line.substr(24, 8));
+    snap.buy_tick_size = static_cast<uint8_t>(parseInt(line.substr(32, 1)));
+    snap.buy_upper_lower_limit = line[33];
+    for (int i = 0; i < 5; i++)
+    {
+        size_t offset = 34 + i * 14;
+        snap.buy_price_ticks[i] = parse6digitPriceTicks(line.substr(offset, 6));
+        snap.buy_volumes[i] = parseInt(line.substr(offset + 6, 8));
+    }
+    snap.sell_tick_size = static_cast<uint8_t>(parseInt(line.substr(104, 1)));
+    snap.sell_upper_lower_limit = line[105];
+    for (int i = 0; i < 5; i++)
+    {
+        size_t offset = 106 + i * 14;
+        snap.sell_price_ticks[i] = parse6digitPriceTicks(line.substr(offset, 6));
+        snap.sell_volumes[i] = parseInt(line.substr(offset + 6, 8));
+    }
+    snap.display_date = static_cast<uint32_t>(parseInt(line.substr(176, 8)));
+    copyChars(snap.match_staff, line.substr(184, 2));
+    return snap;
+}
+
+inline TwseTransactionPacked parseTransactionLinePacked(std::string_view line, SymbolTable &symbols)
+{
+    if (line.size() < 63)
+    {
+        throw std::runtime_error("Line too short (MTH requires 63 chars).");
+    }
+    TwseTransactionPacked tx{};
+    tx.trade_date = static_cast<uint32_t>(parseInt(line.substr(0, 8)));
+    copyChars(tx.securities_code, line.substr(8, 6));
+    tx.symbol_id = symbols.intern(rStrip(line.substr(8, 6)));
+    tx.buy_sell = line[14];
+    tx.trade_type_code = static_cast<uint8_t>(parseInt(line.substr(15, 1)));
+    tx.trade_time = static_cast<uint32_t>(parseInt(line.substr(16, 8)));
+    copyChars(tx.trade_number, line.substr(24, 8));
+    copyChars(tx.order_number_ii, line.substr(32, 5));
+    tx.trade_price_ticks = parsePriceTicks(line.substr(37, 7));
+    tx.trade_volume = parseInt(line.substr(44, 9));
+    copyChars(tx.trading_report, line.substr(53, 4));
+    tx.order_type_code = static_cast<uint8_t>(parseInt(line.substr(57, 1)));
+    tx.type_of_investor = line[58];
+    copyChars(tx.order_number_i, line.substr(59, 4));
+    return tx;
+}
+
+//------------------------------------------------------------------------------
+// 3. Packed loaders (mmap, zero per-record allocation)
+//------------------------------------------------------------------------------
+
+inline std::vector<TwseOrderBookPacked> loadOdrFilePacked(const std::string &filepath,
+                                                          SymbolTable &symbols)
+{
+    MappedFile file(filepath);
+    std::vector<TwseOrderBookPacked> records;
+    records.reserve(file.size() / 60);
+    forEachRawRecord(file.view(), 59, [&](std::string_view line)
+                     { records.push_back(parseOrderLinePacked(line, symbols)); });
+    return records;
+}
+
+inline std::vector<TwseSnapshotPacked> loadDspFilePacked(const std::string &filepath,
+                                                         SymbolTable &symbols)
+{
+    MappedFile file(filepath);
+    std::vector<TwseSnapshotPacked> records;
+    records.reserve(file.size() / 187);
+    forEachRawRecord(file.view(), 186, [&](std::string_view line)
+                     { records.push_back(parseSnapshotLinePacked(line, symbols)); });
+    return records;
+}
+
+inline std::vector<TwseTransactionPacked> loadMthFilePacked(const std::string &filepath,
+                                                            SymbolTable &symbols)
+{
+    MappedFile file(filepath);
+    std::vector<TwseTransactionPacked> records;
+    records.reserve(file.size() / 64);
+    forEachRawRecord(file.view(), 63, [&](std::string_view line)
+                     { records.push_back(parseTransactionLinePacked(line, symbols)); });
+    return records;
+}
+
+#endif // TWSE_PACKED_HPP
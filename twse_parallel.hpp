@@ -0,0 +1,137 @@
+#ifndef TWSE_PARALLEL_HPP
+#define TWSE_PARALLEL_HPP
+
+// Multi-core chunked parsing of the daily fixed-width files.
+//
+// Records are fixed-width (59/186/63 chars + newline), so a file splits
+// cleanly on record boundaries: we mmap it once (twse_mmap.hpp), cut the
+// buffer into one chunk per worker - snapping each cut forward to the next
+// newline - parse the chunks on a thread pool, and concatenate the per-chunk
+// vectors in file order. Output is identical to the single-threaded loaders.
+
+#include "twse_mmap.hpp"
+
+#include <thread>
+#include <utility> // for std::make_move_iterator
+
+//------------------------------------------------------------------------------
+// 1. Chunk splitting
+//------------------------------------------------------------------------------
+
+// Split `buffer` into at most `num_chunks` slices whose boundaries fall just
+// after a newline, so no record straddles two chunks.
+inline std::vector<std::string_view> splitOnRecordBoundaries(std::string_view buffer,
+                                                             unsigned num_chunks)
+{
+    std::vector<std::string_view> chunks;
+    if (buffer.empty() || num_chunks == 0)
+    {
+        return chunks;
+    }
+    size_t target = buffer.size() / num_chunks;
+    size_t begin = 0;
+    for (unsigned i = 0; i < num_chunks && begin < buffer.size(); i++)
+    {
+        size_t end = (i + 1 == num_chunks) ? buffer.size() : begin + target;
+        if (end >= buffer.size())
+        {
+            end = buffer.size();
+        }
+        else
+        {
+            // snap forward to just past the next newline
+            size_t nl = buffer.find('\n', end);
+            end = (nl == std::string_view::npos) ? buffer.size() : nl + 1;
+        }
+        chunks.push_back(buffer.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+//------------------------------------------------------------------------------
+// 2. Generic parallel load
+//------------------------------------------------------------------------------
+
+// ParseFn: Record(std::string_view line). num_threads == 0 means "all cores".
+template <typename Record, typename ParseFn>
+inline std::vector<Record> loadFileParallel(const std::string &filepath,
+                                            size_t record_width,
+                                            ParseFn parse,
+                                            unsigned num_threads = 0)
+{
+    if (num_threads == 0)
+    {
+        num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0)
+        {
+            num_threads = 1;
+        }
+    }
+
+    MappedFile file(filepath);
+    std::vector<std::string_view> chunks = splitOnRecordBoundaries(file.view(), num_threads);
+
+    std::vector<std::vector<Record>> partials(chunks.size());
+    std::vector<std::thread> workers;
+    workers.reserve(chunks.size());
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        workers.emplace_back([&, i]()
+                             {
+            std::vector<Record> &out = partials[i];
+            out.reserve(chunks[i].size() / (record_width + 1));
+            forEachRawRecord(chunks[i], record_width, [&](std::string_view line)
+                             { out.push_back(parse(line)); }); });
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+
+    // Concatenate in file order
+    size_t total = 0;
+    for (const auto &part : partials)
+    {
+        total += part.size();
+    }
+    std::vector<Record> records;
+    records.reserve(total);
+    for (auto &part : partials)
+    {
+        records.insert(records.end(),
+                       std::make_move_iterator(part.begin()),
+                       std::make_move_iterator(part.end()));
+    }
+    return records;
+}
+
+//------------------------------------------------------------------------------
+// 3. Per-format entry points
+//------------------------------------------------------------------------------
+
+inline std::vector<TwseOrderBook> loadOdrFileParallel(const std::string &filepath,
+                                                      unsigned num_threads = 0)
+{
+    return loadFileParallel<TwseOrderBook>(
+        filepath, 59, [](std::string_view line) { return parseOrderLine(line); },
+        num_threads);
+}
+
+inline std::vector<TwseSnapshot> loadDspFileParallel(const std::string &filepath,
+                                                     unsigned num_threads = 0)
+{
+    return loadFileParallel<TwseSnapshot>(
+        filepath, 186, [](std::string_view line) { return parseSnapshotLine(line); },
+        num_threads);
+}
+
+inline std::vector<TwseTransaction> loadMthFileParallel(const std::string &filepath,
+                                                        unsigned num_threads = 0)
+{
+    return loadFileParallel<TwseTransaction>(
+        filepath, 63, [](std::string_view line) { return parseTransactionLine(line); },
+        num_threads);
+}
+
+#endif // TWSE_PARALLEL_HPP
@@ -0,0 +1,227 @@
+#ifndef TWSE_PARTITION_HPP
+#define TWSE_PARTITION_HPP
+
+// Per-symbol partitioned output: one JSONL file per securities code.
+//
+// Downstream per-stock analytics want a converted day split by symbol,
+// which used to mean a second groupby-and-write pass over the full output.
+// This writer does the split during the single parse pass instead: each
+// serialized record is routed by its interned symbol id into a per-symbol
+// buffer, and full buffers are drained by a small pool of writer threads
+// pulling from one shared queue - whichever writer is idle takes the next
+// buffer, so one hot symbol (2330...) never serializes the run behind a
+// single writer.
+//
+// Two deliberate limits, both from FIX_TOO_MANY_OPEN_FILES.md:
+//
+//   - Writers open a partition file only for the duration of one append
+//     and hold at most one each, so the open-file budget is the writer
+//     count - single digits, nowhere near the descriptor limit a
+//     per-symbol writer map runs into on a few hundred codes.
+//   - Records batch up in memory (kFlushBytes per symbol) before any
+//     write, so cold symbols cost a buffer, not a file handle.
+//
+// Per-symbol ordering is preserved without ordering the queue: a partition
+// has at most one flush in flight, and the writer that owns it keeps
+// draining that partition's buffer until it is empty before picking up
+// other work.
+
+#include "twse_pipeline.hpp" // for BoundedQueue
+#include "twse_symbols.hpp"
+
+#include <deque>
+#include <filesystem>
+
+//------------------------------------------------------------------------------
+// 1. Partitioned writer
+//------------------------------------------------------------------------------
+
+class PartitionedWriter
+{
+public:
+    static constexpr size_t kFlushBytes = 256 << 10; // per-symbol batch size
+
+    explicit PartitionedWriter(const std::string &output_dir, unsigned writer_threads = 4)
+        : output_dir_(output_dir), queue_(writer_threads * 4)
+    {
+        std::filesystem::create_directories(output_dir_);
+        for (unsigned t = 0; t < writer_threads; t++)
+        {
+            writers_.emplace_back([this]() { writerLoop(); });
+        }
+    }
+
+    ~PartitionedWriter()
+    {
+        try
+        {
+            if (!closed_)
+            {
+                close();
+            }
+        }
+        catch (...) // destructors must not throw; close() explicitly to see errors
+        {
+        }
+    }
+
+    PartitionedWriter(const PartitionedWriter &) = delete;
+    PartitionedWriter &operator=(const PartitionedWriter &) = delete;
+
+    // Append one serialized record (including its '\n') to the partition of
+    // `symbol_id`. `code` names the output file and only matters the first
+    // time an id is seen.
+    void append(uint32_t symbol_id, std::string_view code, std::string_view line)
+    {
+        FlushTask task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (symbol_id >= partitions_.size())
+            {
+                partitions_.resize(symbol_id + 1);
+            }
+            Partition &p = partitions_[symbol_id];
+            if (p.path.empty())
+            {
+                p.path = output_dir_ + "/" + std::string(code) + ".jsonl";
+            }
+            p.buf.append(line.data(), line.size());
+            if (p.buf.size() >= kFlushBytes && !p.in_flight)
+            {
+                p.in_flight = true;
+                task.part = &p;
+                task.data = std::move(p.buf);
+                p.buf.clear();
+            }
+        }
+        if (task.part != nullptr) // push outside the lock; it can block
+        {
+            queue_.push(std::move(task));
+        }
+    }
+
+    // Flush every remaining buffer and join the writers. Idempotent.
+    void close()
+    {
+        closed_ = true;
+        std::vector<FlushTask> tail;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Partition &p : partitions_)
+            {
+                if (!p.buf.empty() && !p.in_flight)
+                {
+                    p.in_flight = true;
+                    FlushTask task;
+                    task.part = &p;
+                    task.data = std::move(p.buf);
+                    p.buf.clear();
+                    tail.push_back(std::move(task));
+                }
+                // in-flight partitions drain their own buffers in writerLoop
+            }
+        }
+        for (FlushTask &task : tail)
+        {
+            queue_.push(std::move(task));
+        }
+        queue_.close();
+        for (auto &w : writers_)
+        {
+            w.join();
+        }
+        writers_.clear();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_.empty())
+        {
+            throw std::runtime_error(error_);
+        }
+    }
+
+    size_t partitionCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t n = 0;
+        for (const Partition &p : partitions_)
+        {
+            n += p.path.empty() ? 0 : 1;
+        }
+        return n;
+    }
+
+private:
+    struct Partition
+    {
+        std::string path;
+        std::string buf;
+        bool in_flight = false;
+    };
+
+    struct FlushTask
+    {
+        Partition *part = nullptr;
+        std::string data;
+    };
+
+    // A failed write (disk full, unwritable dir) is remembered and rethrown
+    // from close() - throwing out of a detached loop would just terminate.
+    void writerLoop()
+    {
+        FlushTask task;
+        while (queue_.pop(task))
+        {
+            for (;;)
+            {
+                try
+                {
+                    writeOut(task.part->path, task.data);
+                }
+                catch (const std::exception &ex)
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (error_.empty())
+                    {
+                        error_ = ex.what();
+                    }
+                    task.part->in_flight = false;
+                    break;
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (task.part->buf.empty())
+                {
+                    task.part->in_flight = false;
+                    break;
+                }
+                // more arrived while we wrote; keep draining this partition
+                // ourselves so its records stay in order
+                task.data = std::move(task.part->buf);
+                task.part->buf.clear();
+            }
+        }
+    }
+
+    static void writeOut(const std::string &path, const std::string &data)
+    {
+        StatsTimer timer(StatsPhase::Write);
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        if (!out.is_open())
+        {
+            throw std::runtime_error("Cannot open partition file: " + path);
+        }
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (RunStats *stats = runStats())
+        {
+            stats->addBytesWritten(data.size());
+        }
+    }
+
+    std::string output_dir_;
+    mutable std::mutex mutex_;
+    std::deque<Partition> partitions_; // symbol id -> partition, stable addresses
+    BoundedQueue<FlushTask> queue_;
+    std::vector<std::thread> writers_;
+    std::string error_; // first writer failure, rethrown from close()
+    bool closed_ = false;
+};
+
+#endif // TWSE_PARTITION_HPP
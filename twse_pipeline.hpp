@@ -0,0 +1,234 @@
+#ifndef TWSE_PIPELINE_HPP
+#define TWSE_PIPELINE_HPP
+
+// Three-stage pipelined file conversion: read / parse+serialize / write.
+//
+// The sequential convert loop leaves the disk idle while JSON is formatted
+// and the CPU idle during reads. Here a reader thread fills a bounded queue
+// with multi-MB chunks cut at record boundaries, parser workers turn each
+// chunk into serialized NDJSON, and a writer thread drains a second bounded
+// queue, reordering by chunk sequence number so the output is byte-identical
+// to the sequential path. Both queues are bounded, so memory stays capped at
+// a handful of chunks however large the file is.
+
+#include "twse_tick.hpp"
+#include "twse_mmap.hpp" // for forEachRawRecord
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <queue>
+
+//------------------------------------------------------------------------------
+// 1. Bounded MPMC queue
+//------------------------------------------------------------------------------
+
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    void push(T &&item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [&] { return queue_.size() < capacity_; });
+        queue_.push(std::move(item));
+        not_empty_.notify_one();
+    }
+
+    // Returns false once the queue is closed and drained.
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [&] { return !queue_.empty() || closed_; });
+        if (queue_.empty())
+        {
+            return false;
+        }
+        item = std::move(queue_.front());
+        queue_.pop();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+private:
+    size_t capacity_;
+    std::queue<T> queue_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    bool closed_ = false;
+};
+
+//------------------------------------------------------------------------------
+// 2. Pipeline
+//------------------------------------------------------------------------------
+
+struct PipelineChunk
+{
+    size_t seq = 0;
+    std::string data;
+};
+
+// Convert one fixed-width file to NDJSON. perLine(line, out) appends the
+// serialized record plus '\n' to out (see the appendXxxJson serializers in
+// twse_json.hpp). Returns the number of records converted.
+template <typename PerLineFn>
+inline size_t convertFilePipelined(const std::string &input_path,
+                                   const std::string &output_path,
+                                   size_t record_width,
+                                   PerLineFn perLine,
+                                   unsigned parser_threads = 0)
+{
+    constexpr size_t kChunkBytes = 4 << 20; // 4 MB read blocks
+    constexpr size_t kQueueDepth = 8;
+
+    if (parser_threads == 0)
+    {
+        unsigned hw = std::thread::hardware_concurrency();
+        parser_threads = (hw > 2) ? hw - 2 : 1; // leave a core each for reader/writer
+    }
+
+    std::ifstream fin(input_path, std::ios::binary);
+    if (!fin.is_open())
+    {
+        throw std::runtime_error("Cannot open input file: " + input_path);
+    }
+    std::ofstream fout(output_path, std::ios::binary);
+    if (!fout.is_open())
+    {
+        throw std::runtime_error("Cannot open output file: " + output_path);
+    }
+
+    BoundedQueue<PipelineChunk> raw_queue(kQueueDepth);
+    BoundedQueue<PipelineChunk> out_queue(kQueueDepth);
+    std::atomic<size_t> record_count{0};
+
+    // Stage 1: reader - cut the stream into chunks ending on a newline.
+    std::thread reader([&]() {
+        std::string carry;
+        size_t seq = 0;
+        while (fin)
+        {
+            PipelineChunk chunk;
+            chunk.data.resize(carry.size() + kChunkBytes);
+            std::memcpy(&chunk.data[0], carry.data(), carry.size());
+            {
+                StatsTimer timer(StatsPhase::Read);
+                fin.read(&chunk.data[carry.size()], static_cast<std::streamsize>(kChunkBytes));
+            }
+            size_t got = carry.size() + static_cast<size_t>(fin.gcount());
+            if (RunStats *stats = runStats())
+            {
+                stats->addBytesRead(static_cast<size_t>(fin.gcount()));
+            }
+            chunk.data.resize(got);
+            carry.clear();
+            if (got == 0)
+            {
+                break;
+            }
+            size_t last_nl = chunk.data.rfind('\n');
+            if (last_nl == std::string::npos)
+            {
+                if (fin) // mid-record; keep reading
+                {
+                    carry = std::move(chunk.data);
+                    continue;
+                }
+            }
+            else if (last_nl + 1 < chunk.data.size())
+            {
+                carry = chunk.data.substr(last_nl + 1);
+                chunk.data.resize(last_nl + 1);
+            }
+            chunk.seq = seq++;
+            raw_queue.push(std::move(chunk));
+        }
+        if (!carry.empty()) // final record when the file has no trailing newline
+        {
+            PipelineChunk chunk;
+            chunk.seq = seq++;
+            chunk.data = std::move(carry);
+            raw_queue.push(std::move(chunk));
+        }
+        raw_queue.close();
+    });
+
+    // Stage 2: parser workers - chunk of raw lines -> chunk of NDJSON.
+    std::vector<std::thread> parsers;
+    for (unsigned t = 0; t < parser_threads; t++)
+    {
+        parsers.emplace_back([&]() {
+            PipelineChunk chunk;
+            while (raw_queue.pop(chunk))
+            {
+                PipelineChunk out;
+                out.seq = chunk.seq;
+                out.data.reserve(chunk.data.size() * 4);
+                size_t n = 0;
+                {
+                    StatsTimer timer(StatsPhase::Parse);
+                    forEachRawRecord(std::string_view(chunk.data), record_width,
+                                     [&](std::string_view line) {
+                                         perLine(line, out.data);
+                                         n++;
+                                     });
+                }
+                record_count.fetch_add(n, std::memory_order_relaxed);
+                if (RunStats *stats = runStats())
+                {
+                    stats->addRecords(n);
+                }
+                out_queue.push(std::move(out));
+            }
+        });
+    }
+
+    // Stage 3: writer - reorder by sequence number and stream out.
+    std::thread writer([&]() {
+        std::map<size_t, std::string> pending;
+        size_t next_seq = 0;
+        PipelineChunk chunk;
+        while (out_queue.pop(chunk))
+        {
+            pending.emplace(chunk.seq, std::move(chunk.data));
+            while (!pending.empty() && pending.begin()->first == next_seq)
+            {
+                const std::string &data = pending.begin()->second;
+                {
+                    StatsTimer timer(StatsPhase::Write);
+                    fout.write(data.data(), static_cast<std::streamsize>(data.size()));
+                }
+                if (RunStats *stats = runStats())
+                {
+                    stats->addBytesWritten(data.size());
+                }
+                pending.erase(pending.begin());
+                next_seq++;
+            }
+        }
+    });
+
+    reader.join();
+    for (auto &p : parsers)
+    {
+        p.join();
+    }
+    out_queue.close();
+    writer.join();
+
+    return record_count.load();
+}
+
+#endif // TWSE_PIPELINE_HPP
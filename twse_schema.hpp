@@ -0,0 +1,232 @@
+#ifndef TWSE_SCHEMA_HPP
+#define TWSE_SCHEMA_HPP
+
+// constexpr schema tables for the three fixed-width layouts.
+//
+// The field offsets in parseOrderLine and its siblings are hand-transcribed
+// magic numbers (0, 8, 14, 15, 16, ...), which the compiler can only see as
+// arithmetic, never as a layout. The tables below describe each format as
+// data - field name, offset, width, decode type - checked by static_assert
+// against the record widths the hand-written parsers assume (59/186/63), so
+// the two can't drift apart silently.
+//
+// visitSchema<Tag>(line, fn) is a parser generated from the table at compile
+// time: the field loop unrolls via index_sequence, every offset and width is
+// a constant in the emitted code, and the line-length check runs once up
+// front instead of per field. New TWSE format revisions (the v2/v3 layouts
+// in README_data_v2.md / README_data_v3.md) become new tables, not new
+// hand-written parsers.
+
+#include "twse_tick.hpp"
+
+#include <utility> // for std::index_sequence
+
+//------------------------------------------------------------------------------
+// 1. Field description
+//------------------------------------------------------------------------------
+
+enum class FieldType : uint8_t
+{
+    Text,      // raw chars, trailing-space padded
+    Char,      // single char code ('B'/'S', match flag, ...)
+    UInt,      // unsigned digit run (dates, times, volumes, codes)
+    SignedInt, // leading '+'/'-' then digits (changed_trade_volume)
+    Price,     // decimal text, e.g. " 142.50" (parseFloat)
+    Price100   // 6-digit price in hundredths, e.g. "002860" -> 28.60
+};
+
+struct FieldDesc
+{
+    const char *name;
+    uint16_t offset;
+    uint16_t width;
+    FieldType type;
+};
+
+// Record width implied by a table: end of its last-reaching field.
+template <size_t N>
+constexpr size_t schemaWidth(const FieldDesc (&schema)[N])
+{
+    size_t width = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        size_t end = schema[i].offset + schema[i].width;
+        width = end > width ? end : width;
+    }
+    return width;
+}
+
+//------------------------------------------------------------------------------
+// 2. The three layouts as data
+//------------------------------------------------------------------------------
+
+inline constexpr FieldDesc kOdrSchema[] = {
+    {"order_date", 0, 8, FieldType::UInt},
+    {"securities_code", 8, 6, FieldType::Text},
+    {"buy_sell", 14, 1, FieldType::Char},
+    {"trade_type_code", 15, 1, FieldType::UInt},
+    {"order_time", 16, 8, FieldType::UInt},
+    {"order_number_ii", 24, 5, FieldType::Text},
+    {"changed_trade_code", 29, 1, FieldType::UInt},
+    {"order_price", 30, 7, FieldType::Price},
+    {"changed_trade_volume", 37, 11, FieldType::SignedInt},
+    {"order_type_code", 48, 1, FieldType::UInt},
+    {"notes_investors_channel", 49, 1, FieldType::Char},
+    {"order_report_print", 50, 4, FieldType::Text},
+    {"type_of_investor", 54, 1, FieldType::Char},
+    {"order_number_i", 55, 4, FieldType::Text},
+};
+
+inline constexpr FieldDesc kDspSchema[] = {
+    {"securities_code", 0, 6, FieldType::Text},
+    {"display_time", 6, 8, FieldType::UInt},
+    {"remark", 14, 1, FieldType::Char},
+    {"trend_flag", 15, 1, FieldType::Char},
+    {"match_flag", 16, 1, FieldType::Char},
+    {"trade_upper_lower", 17, 1, FieldType::Char},
+    {"trade_price", 18, 6, FieldType::Price100},
+    {"transaction_volume", 24, 8, FieldType::UInt},
+    {"buy_tick_size", 32, 1, FieldType::UInt},
+    {"buy_upper_lower_limit", 33, 1, FieldType::Char},
+    {"buy_price_1", 34, 6, FieldType::Price100},
+    {"buy_volume_1", 40, 8, FieldType::UInt},
+    {"buy_price_2", 48, 6, FieldType::Price100},
+    {"buy_volume_2", 54, 8, FieldType::UInt},
+    {"buy_price_3", 62, 6, FieldType::Price100},
+    {"buy_volume_3", 68, 8, FieldType::UInt},
+    {"buy_price_4", 76, 6, FieldType::Price100},
+    {"buy_volume_4", 82, 8, FieldType::UInt},
+    {"buy_price_5", 90, 6, FieldType::Price100},
+    {"buy_volume_5", 96, 8, FieldType::UInt},
+    {"sell_tick_size", 104, 1, FieldType::UInt},
+    {"sell_upper_lower_limit", 105, 1, FieldType::Char},
+    {"sell_price_1", 106, 6, FieldType::Price100},
+    {"sell_volume_1", 112, 8, FieldType::UInt},
+    {"sell_price_2", 120, 6, FieldType::Price100},
+    {"sell_volume_2", 126, 8, FieldType::UInt},
+    {"sell_price_3", 134, 6, FieldType::Price100},
+    {"sell_volume_3", 140, 8, FieldType::UInt},
+    {"sell_price_4", 148, 6, FieldType::Price100},
+    {"sell_volume_4", 154, 8, FieldType::UInt},
+    {"sell_price_5", 162, 6, FieldType::Price100},
+    {"sell_volume_5", 168, 8, FieldType::UInt},
+    {"display_date", 176, 8, FieldType::UInt},
+    {"match_staff", 184, 2, FieldType::Text},
+};
+
+inline constexpr FieldDesc kMthSchema[] = {
+    {"trade_date", 0, 8, FieldType::UInt},
+    {"securities_code", 8, 6, FieldType::Text},
+    {"buy_sell", 14, 1, FieldType::Char},
+    {"trade_type_code", 15, 1, FieldType::UInt},
+    {"trade_time", 16, 8, FieldType::UInt},
+    {"trade_number", 24, 8, FieldType::Text},
+    {"order_number_ii", 32, 5, FieldType::Text},
+    {"trade_price", 37, 7, FieldType::Price},
+    {"trade_volume", 44, 9, FieldType::UInt},
+    {"trading_report", 53, 4, FieldType::Text},
+    {"order_type_code", 57, 1, FieldType::UInt},
+    {"type_of_investor", 58, 1, FieldType::Char},
+    {"order_number_i", 59, 4, FieldType::Text},
+};
+
+// The tables and the hand-written parsers must agree on record geometry.
+static_assert(schemaWidth(kOdrSchema) == 59, "ODR schema drifted from parseOrderLine");
+static_assert(schemaWidth(kDspSchema) == 186, "DSP schema drifted from parseSnapshotLine");
+static_assert(schemaWidth(kMthSchema) == 63, "MTH schema drifted from parseTransactionLine");
+
+// Tag types let the schema travel as a template argument in C++17.
+struct OdrSchemaTag
+{
+    static constexpr const FieldDesc *fields = kOdrSchema;
+    static constexpr size_t count = sizeof(kOdrSchema) / sizeof(FieldDesc);
+    static constexpr size_t width = schemaWidth(kOdrSchema);
+};
+
+struct DspSchemaTag
+{
+    static constexpr const FieldDesc *fields = kDspSchema;
+    static constexpr size_t count = sizeof(kDspSchema) / sizeof(FieldDesc);
+    static constexpr size_t width = schemaWidth(kDspSchema);
+};
+
+struct MthSchemaTag
+{
+    static constexpr const FieldDesc *fields = kMthSchema;
+    static constexpr size_t count = sizeof(kMthSchema) / sizeof(FieldDesc);
+    static constexpr size_t width = schemaWidth(kMthSchema);
+};
+
+//------------------------------------------------------------------------------
+// 3. Generated parser - compile-time unrolled visit over one record
+//------------------------------------------------------------------------------
+
+// Decoded value of one field; which member is live follows desc.type.
+struct FieldValue
+{
+    std::string_view text; // Text / Char (raw slice, also set for all types)
+    int64_t num = 0;       // UInt / SignedInt
+    PriceTicks price_ticks = 0; // Price / Price100, exact hundredths
+    float price = 0.0f;         // same value as a float, for display math
+};
+
+template <typename Tag, size_t I, typename Fn>
+inline void visitSchemaField(std::string_view line, Fn &fn)
+{
+    constexpr FieldDesc desc = Tag::fields[I];
+    std::string_view raw = line.substr(desc.offset, desc.width);
+    FieldValue value;
+    value.text = raw;
+    if constexpr (desc.type == FieldType::UInt)
+    {
+        value.num = parseInt(raw);
+    }
+    else if constexpr (desc.type == FieldType::SignedInt)
+    {
+        value.num = parseSignAndInt(raw);
+    }
+    else if constexpr (desc.type == FieldType::Price)
+    {
+        value.price_ticks = parsePriceTicks(raw);
+        value.price = ticksToPrice(value.price_ticks);
+    }
+    else if constexpr (desc.type == FieldType::Price100)
+    {
+        value.price_ticks = parse6digitPriceTicks(raw);
+        value.price = ticksToPrice(value.price_ticks);
+    }
+    fn(desc, value);
+}
+
+template <typename Tag, typename Fn, size_t... I>
+inline void visitSchemaImpl(std::string_view line, Fn &fn, std::index_sequence<I...>)
+{
+    (visitSchemaField<Tag, I>(line, fn), ...);
+}
+
+// Calls fn(const FieldDesc &, const FieldValue &) once per field, in layout
+// order. One bounds check up front; per-field offsets are compile-time
+// constants, so the loop is fully unrolled.
+template <typename Tag, typename Fn>
+inline void visitSchema(std::string_view line, Fn &&fn)
+{
+    if (line.size() < Tag::width)
+    {
+        throw std::runtime_error("Line too short for schema (needs " +
+                                 std::to_string(Tag::width) + " chars).");
+    }
+    visitSchemaImpl<Tag>(line, fn, std::make_index_sequence<Tag::count>{});
+}
+
+// Materialized form for callers that want the whole record decoded.
+template <typename Tag>
+inline std::array<FieldValue, Tag::count> parseWithSchema(std::string_view line)
+{
+    std::array<FieldValue, Tag::count> values;
+    size_t i = 0;
+    visitSchema<Tag>(line, [&](const FieldDesc &, const FieldValue &v)
+                     { values[i++] = v; });
+    return values;
+}
+
+#endif // TWSE_SCHEMA_HPP
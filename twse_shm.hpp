@@ -0,0 +1,237 @@
+#ifndef TWSE_SHM_HPP
+#define TWSE_SHM_HPP
+
+// Shared-memory export of packed record arrays ("TWSH").
+//
+// Several local consumers (typically Python research processes) want the
+// same day's parsed records at once; each re-reading the JSONL multiplies
+// both the parse cost and the resident memory. This publisher parses once
+// and drops the packed POD array (twse_packed.hpp) into a named POSIX
+// shared-memory segment; any number of readers then mmap the same physical
+// pages read-only. One parse, one copy in RAM, N readers.
+//
+// Segment layout (fixed offsets, no pointers - the mapping address differs
+// per process):
+//
+//     [64-byte ShmHeader] [record array] [pad to 8] [symbol table]
+//
+// The symbol table is the interned id -> code mapping the packed parsers
+// built: symbol_count entries of 8 space-padded chars, entry i belonging to
+// symbol_id i. Records are the in-memory packed structs verbatim, so the
+// same layout asserts in twse_packed.hpp guard this format too; layout
+// changes bump kShmVersion.
+//
+// The segment outlives the publisher (that is the point) - it persists in
+// /dev/shm until shmUnpublish() or a reboot removes it.
+
+#include "twse_packed.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// 1. Header
+//------------------------------------------------------------------------------
+
+constexpr uint16_t kShmVersion = 1;
+constexpr size_t kShmSymbolWidth = 8; // chars per symbol table entry
+
+struct ShmHeader
+{
+    char magic[4];   // "TWSH"
+    uint16_t version;
+    uint16_t format; // ColumnarFormat values: 1 ODR / 2 DSP / 3 MTH
+    uint32_t record_size; // sizeof one packed record, a layout checksum
+    uint32_t symbol_count;
+    uint64_t record_count;
+    uint64_t record_offset; // byte offset of the record array
+    uint64_t symbol_offset; // byte offset of the symbol table
+    char reserved[24];
+};
+static_assert(sizeof(ShmHeader) == 64, "header must stay one cache line");
+
+template <typename Rec>
+constexpr uint16_t shmFormatOf();
+template <>
+constexpr uint16_t shmFormatOf<TwseOrderBookPacked>() { return 1; }
+template <>
+constexpr uint16_t shmFormatOf<TwseSnapshotPacked>() { return 2; }
+template <>
+constexpr uint16_t shmFormatOf<TwseTransactionPacked>() { return 3; }
+
+//------------------------------------------------------------------------------
+// 2. Publisher
+//------------------------------------------------------------------------------
+
+// Create (or replace) segment `name` ("/twse_dsp_20200101" style - shm_open
+// requires the leading slash) holding `records` plus the symbol table that
+// its symbol_ids index into.
+template <typename Rec>
+inline void shmPublish(const std::string &name, const std::vector<Rec> &records,
+                       const SymbolTable &symbols)
+{
+    static_assert(std::is_trivially_copyable<Rec>::value, "records are memcpy'd");
+
+    size_t record_bytes = records.size() * sizeof(Rec);
+    size_t symbol_offset = (sizeof(ShmHeader) + record_bytes + 7) & ~size_t(7);
+    size_t total = symbol_offset + symbols.size() * kShmSymbolWidth;
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot create shared memory segment: " + name);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(total)) != 0)
+    {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Cannot size shared memory segment: " + name);
+    }
+    void *p = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd); // mapping stays valid after close
+    if (p == MAP_FAILED)
+    {
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Cannot map shared memory segment: " + name);
+    }
+
+    char *base = static_cast<char *>(p);
+    ShmHeader hdr{};
+    hdr.magic[0] = 'T';
+    hdr.magic[1] = 'W';
+    hdr.magic[2] = 'S';
+    hdr.magic[3] = 'H';
+    hdr.version = kShmVersion;
+    hdr.format = shmFormatOf<Rec>();
+    hdr.record_size = sizeof(Rec);
+    hdr.symbol_count = static_cast<uint32_t>(symbols.size());
+    hdr.record_count = records.size();
+    hdr.record_offset = sizeof(ShmHeader);
+    hdr.symbol_offset = symbol_offset;
+    std::memcpy(base, &hdr, sizeof(hdr));
+    if (!records.empty())
+    {
+        std::memcpy(base + hdr.record_offset, records.data(), record_bytes);
+    }
+    for (uint32_t id = 0; id < hdr.symbol_count; id++)
+    {
+        char *entry = base + symbol_offset + size_t(id) * kShmSymbolWidth;
+        std::memset(entry, ' ', kShmSymbolWidth);
+        const std::string &code = symbols.code(id);
+        std::memcpy(entry, code.data(), std::min(code.size(), kShmSymbolWidth));
+    }
+    ::munmap(p, total);
+}
+
+inline void shmUnpublish(const std::string &name)
+{
+    ::shm_unlink(name.c_str());
+}
+
+//------------------------------------------------------------------------------
+// 3. Reader view
+//------------------------------------------------------------------------------
+
+// Read-only zero-copy view over a published segment; pointers stay valid for
+// the lifetime of the struct (it owns the mapping, not the segment).
+template <typename Rec>
+struct ShmView
+{
+    const Rec *records = nullptr;
+    uint64_t count = 0;
+    const char *symbol_table = nullptr; // symbol_count * kShmSymbolWidth chars
+    uint32_t symbol_count = 0;
+
+    std::string_view symbol(uint32_t id) const
+    {
+        return rStrip(std::string_view(symbol_table + size_t(id) * kShmSymbolWidth,
+                                       kShmSymbolWidth));
+    }
+
+    ShmView() = default;
+    ~ShmView() { release(); }
+    ShmView(const ShmView &) = delete;
+    ShmView &operator=(const ShmView &) = delete;
+    ShmView(ShmView &&other) noexcept { takeFrom(other); }
+    ShmView &operator=(ShmView &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    void *base_ = nullptr;
+    size_t size_ = 0;
+
+private:
+    void release()
+    {
+        if (base_ != nullptr)
+        {
+            ::munmap(base_, size_);
+            base_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    void takeFrom(ShmView &other)
+    {
+        records = other.records;
+        count = other.count;
+        symbol_table = other.symbol_table;
+        symbol_count = other.symbol_count;
+        base_ = other.base_;
+        size_ = other.size_;
+        other.base_ = nullptr;
+        other.size_ = 0;
+    }
+};
+
+template <typename Rec>
+inline ShmView<Rec> shmAttach(const std::string &name)
+{
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open shared memory segment: " + name);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(ShmHeader)))
+    {
+        ::close(fd);
+        throw std::runtime_error("Shared memory segment too small: " + name);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void *p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot map shared memory segment: " + name);
+    }
+
+    ShmHeader hdr;
+    std::memcpy(&hdr, p, sizeof(hdr));
+    if (std::memcmp(hdr.magic, "TWSH", 4) != 0 || hdr.version != kShmVersion ||
+        hdr.format != shmFormatOf<Rec>() || hdr.record_size != sizeof(Rec))
+    {
+        ::munmap(p, size);
+        throw std::runtime_error("Shared memory segment has wrong schema: " + name);
+    }
+
+    ShmView<Rec> view;
+    view.base_ = p;
+    view.size_ = size;
+    const char *base = static_cast<const char *>(p);
+    view.records = reinterpret_cast<const Rec *>(base + hdr.record_offset);
+    view.count = hdr.record_count;
+    view.symbol_table = base + hdr.symbol_offset;
+    view.symbol_count = hdr.symbol_count;
+    return view;
+}
+
+#endif // TWSE_SHM_HPP
@@ -0,0 +1,103 @@
+#ifndef TWSE_SYMBOLS_HPP
+#define TWSE_SYMBOLS_HPP
+
+// Symbol interning for securities_code.
+//
+// A day of records stores millions of duplicate copies of ~2,000 distinct
+// codes, and every per-symbol groupby re-hashes those strings. SymbolTable
+// assigns each code a dense uint32_t id on first sight; the interning loaders
+// fill the records' symbol_id field in the same pass as parsing, so symbol
+// comparison downstream becomes a register compare and the id can index flat
+// per-symbol arrays directly (ids are 0..size()-1 in order of first
+// appearance).
+//
+// The table is not thread-safe; with the parallel loaders, intern per chunk
+// and merge, or intern in a second pass.
+
+#include "twse_mmap.hpp"
+
+#include <deque>
+#include <unordered_map>
+
+class SymbolTable
+{
+public:
+    // Return the id for `code`, assigning the next dense id if it is new.
+    uint32_t intern(std::string_view code)
+    {
+        auto it = ids_.find(code);
+        if (it != ids_.end())
+        {
+            return it->second;
+        }
+        uint32_t id = static_cast<uint32_t>(codes_.size());
+        codes_.emplace_back(code);
+        // deque never relocates elements, so the view stays valid
+        ids_.emplace(std::string_view(codes_.back()), id);
+        return id;
+    }
+
+    // Lookup without inserting; kNoSymbolId if the code was never seen.
+    uint32_t find(std::string_view code) const
+    {
+        auto it = ids_.find(code);
+        return (it != ids_.end()) ? it->second : kNoSymbolId;
+    }
+
+    // Map an id back to its text.
+    const std::string &code(uint32_t id) const
+    {
+        return codes_.at(id);
+    }
+
+    size_t size() const { return codes_.size(); }
+
+private:
+    std::unordered_map<std::string_view, uint32_t> ids_; // views into codes_
+    std::deque<std::string> codes_;                      // id -> text, stable storage
+};
+
+//------------------------------------------------------------------------------
+// Interning loaders - same single pass as parsing
+//------------------------------------------------------------------------------
+
+inline std::vector<TwseOrderBook> loadOdrFileInterned(const std::string &filepath,
+                                                      SymbolTable &symbols)
+{
+    MappedFile file(filepath);
+    std::vector<TwseOrderBook> records;
+    records.reserve(file.size() / 60);
+    forEachRawRecord(file.view(), 59, [&](std::string_view line)
+                     {
+        records.push_back(parseOrderLine(line));
+        records.back().symbol_id = symbols.intern(records.back().securities_code); });
+    return records;
+}
+
+inline std::vector<TwseSnapshot> loadDspFileInterned(const std::string &filepath,
+                                                     SymbolTable &symbols)
+{
+    MappedFile file(filepath);
+    std::vector<TwseSnapshot> records;
+    records.reserve(file.size() / 187);
+    forEachRawRecord(file.view(), 186, [&](std::string_view line)
+                     {
+        records.push_back(parseSnapshotLine(line));
+        records.back().symbol_id = symbols.intern(records.back().securities_code); });
+    return records;
+}
+
+inline std::vector<TwseTransaction> loadMthFileInterned(const std::string &filepath,
+                                                        SymbolTable &symbols)
+{
+    MappedFile file(filepath);
+    std::vector<TwseTransaction> records;
+    records.reserve(file.size() / 64);
+    forEachRawRecord(file.view(), 63, [&](std::string_view line)
+                     {
+        records.push_back(parseTransactionLine(line));
+        records.back().symbol_id = symbols.intern(records.back().securities_code); });
+    return records;
+}
+
+#endif // TWSE_SYMBOLS_HPP
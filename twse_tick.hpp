@@ -2,16 +2,21 @@
 #define TWSE_TICK_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
 #include <stdexcept>
-#include <cstdlib> // for std::atoi, std::strtof
-#include <cctype>  // for std::isspace
+#include <cstdint>  // for uint32_t
+#include <cstdlib>  // for std::atoi, std::strtof
+#include <cctype>   // for std::isspace
+#include <charconv> // for std::from_chars
 #include <array>   // for std::array
 #include <sstream>
 #include <iomanip>
 #include <nlohmann/json.hpp>
 
+#include "twse_digits.hpp" // SWAR digit-run decoding for the hot numeric fields
+
 //------------------------------------------------------------------------------
 // 1. Enums and Helper Parsers
 //------------------------------------------------------------------------------
@@ -32,36 +37,117 @@ inline BuySell parseBuySell(const std::string &bs)
     return BuySell::Unknown;
 }
 
+inline BuySell parseBuySell(char bs)
+{
+    if (bs == 'B')
+        return BuySell::Buy;
+    if (bs == 'S')
+        return BuySell::Sell;
+    return BuySell::Unknown;
+}
+
+// Parse an unsigned digit run with std::from_chars - no NUL terminator
+// needed, so the caller can pass a slice of a larger buffer without copying.
+// Leading spaces are skipped to match std::atoi on blank-padded fields.
+inline int parseInt(std::string_view raw)
+{
+    while (!raw.empty() && raw.front() == ' ')
+        raw.remove_prefix(1);
+    // Fast path: the field is a pure digit run (the common case for the
+    // zero-padded price/volume fields) - decode 8 digits per step.
+    uint64_t decoded;
+    if (parseDigitRun(raw, decoded))
+    {
+        return static_cast<int>(decoded);
+    }
+    int value = 0;
+    std::from_chars(raw.data(), raw.data() + raw.size(), value);
+    return value;
+}
+
 // Parse strings like "+0000001000" or "-0000000500"
-inline int parseSignAndInt(const std::string &raw)
+inline int parseSignAndInt(std::string_view raw)
 {
     if (raw.empty())
         return 0;
     // raw[0] is '+' or '-'
-    char sign_char = raw[0];
-    std::string numeric_part = raw.substr(1); // skip sign
-    int magnitude = std::atoi(numeric_part.c_str());
-    return (sign_char == '-') ? -magnitude : magnitude;
+    int magnitude = parseInt(raw.substr(1)); // skip sign
+    return (raw[0] == '-') ? -magnitude : magnitude;
+}
+
+inline int parseSignAndInt(const std::string &raw)
+{
+    return parseSignAndInt(std::string_view(raw));
 }
 
 // Parse float (e.g. "0078.35" -> 78.35)
+inline float parseFloat(std::string_view raw)
+{
+    while (!raw.empty() && raw.front() == ' ')
+        raw.remove_prefix(1);
+    float value = 0.0f;
+    std::from_chars(raw.data(), raw.data() + raw.size(), value);
+    return value;
+}
+
 inline float parseFloat(const std::string &raw)
 {
-    return std::strtof(raw.c_str(), nullptr);
+    return parseFloat(std::string_view(raw));
 }
 
 // Parse small numeric code like "0", "1", "2" -> int
 inline int parseCode(const std::string &raw)
 {
-    return std::atoi(raw.c_str());
+    return parseInt(std::string_view(raw));
+}
+
+// TWSE prices are exact in hundredths, so the canonical in-memory price is
+// an integer tick count (1 tick = 0.01): "0034.60" -> 3460. Exact equality
+// for book building, no float decode/format round trip on the hot path,
+// and integer columns in the binary formats. Convert at API boundaries
+// with ticksToPrice / priceToTicks.
+using PriceTicks = int32_t;
+
+constexpr float ticksToPrice(PriceTicks ticks)
+{
+    return static_cast<float>(ticks) / 100.0f;
+}
+
+inline PriceTicks priceToTicks(float price)
+{
+    return static_cast<PriceTicks>(price * 100.0f + (price < 0 ? -0.5f : 0.5f));
+}
+
+// Decimal price text like "0034.60" (or a plain digit run, meaning whole
+// currency units) -> tick count. Pure integer decode, no float involved.
+inline PriceTicks parsePriceTicks(std::string_view raw)
+{
+    while (!raw.empty() && raw.front() == ' ')
+        raw.remove_prefix(1);
+    size_t dot = raw.find('.');
+    if (dot == std::string_view::npos)
+    {
+        return parseInt(raw) * 100;
+    }
+    return parseInt(raw.substr(0, dot)) * 100 + parseInt(raw.substr(dot + 1, 2));
+}
+
+// 6-digit hundredths field ("002860" => 2860 ticks = 28.60).
+inline PriceTicks parse6digitPriceTicks(std::string_view raw)
+{
+    return parseInt(raw);
 }
 
 // A small helper to parse a 6-digit price (e.g. "002860" => 28.60)
-inline float parse6digitPrice(const std::string &raw)
+inline float parse6digitPrice(std::string_view raw)
 {
     // e.g. "002860" -> int(2860) -> float(28.60)
-    int val = std::atoi(raw.c_str());
-    return val / 100.0f;
+    return parseInt(raw) / 100.0f;
+}
+
+inline float parse6digitPrice(const std::string &raw)
+{
+    return parse6digitPrice(std::string_view(raw));
 }
 
 inline std::string rStrip(const std::string &s)
@@ -74,17 +160,31 @@ inline std::string rStrip(const std::string &s)
     return tmp;
 }
 
+inline std::string_view rStrip(std::string_view s)
+{
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
 //------------------------------------------------------------------------------
 // 2. Data Structures
 //
 // 2.1 Order Book (ODR) - TwseOrderBook
 //------------------------------------------------------------------------------
 
+// Dense interned id for securities_code, assigned by SymbolTable
+// (twse_symbols.hpp). Records parsed without a table keep kNoSymbolId.
+constexpr uint32_t kNoSymbolId = 0xFFFFFFFFu;
+
 struct TwseOrderBook
 {
     // keep these as raw strings (no date/time parse)
     std::string order_date;      // positions [0..7]
     std::string securities_code; // [8..13]
+    uint32_t symbol_id = kNoSymbolId;
 
     BuySell buy_sell; // [14]
 
@@ -93,9 +193,10 @@ struct TwseOrderBook
 
     std::string order_number_ii; // [24..28]
 
-    int changed_trade_code;   // [29] (1..6)
-    float order_price;        // [30..36]
-    int changed_trade_volume; // [37..47]
+    int changed_trade_code;       // [29] (1..6)
+    float order_price;            // [30..36]
+    PriceTicks order_price_ticks; // same field, exact hundredths
+    int changed_trade_volume;     // [37..47]
 
     int order_type_code;                 // [48]
     std::string notes_investors_channel; // [49]
@@ -127,6 +228,15 @@ inline MatchFlag parseMatchFlag(const std::string &mf)
     return MatchFlag::NoMatch;
 }
 
+inline MatchFlag parseMatchFlag(char mf)
+{
+    if (mf == 'Y')
+        return MatchFlag::Matched;
+    if (mf == 'S')
+        return MatchFlag::Stabilize;
+    return MatchFlag::NoMatch;
+}
+
 /*
 struct TwseSnapshot
 {
@@ -165,6 +275,7 @@ struct TwseSnapshot
 struct TwseSnapshot
 {
     std::string securities_code; // [0..5]
+    uint32_t symbol_id = kNoSymbolId;
     std::string display_time;    // [6..13]
 
     std::string remark;            // [14]
@@ -172,20 +283,23 @@ struct TwseSnapshot
     MatchFlag match_flag;          // [16]
     std::string trade_upper_lower; // [17]
 
-    float trade_price;      // [18..23] parse as float
-    int transaction_volume; // [24..31]
+    float trade_price;            // [18..23] parse as float
+    PriceTicks trade_price_ticks; // same field, exact hundredths
+    int transaction_volume;       // [24..31]
 
     int buy_tick_size;                 // [32]
     std::string buy_upper_lower_limit; // [33]
 
     // Instead of one 70-char field, we store arrays:
-    std::array<float, 5> buy_prices; // each from 6 chars in the 70
-    std::array<int, 5> buy_volumes;  // each from 8 chars in the 70
+    std::array<float, 5> buy_prices;            // each from 6 chars in the 70
+    std::array<PriceTicks, 5> buy_price_ticks;  // exact hundredths
+    std::array<int, 5> buy_volumes;             // each from 8 chars in the 70
 
     int sell_tick_size;                 // [104]
     std::string sell_upper_lower_limit; // [105]
-    std::array<float, 5> sell_prices;   // each from 6 chars in the 70
-    std::array<int, 5> sell_volumes;    // each from 8 chars in the 70
+    std::array<float, 5> sell_prices;           // each from 6 chars in the 70
+    std::array<PriceTicks, 5> sell_price_ticks; // exact hundredths
+    std::array<int, 5> sell_volumes;            // each from 8 chars in the 70
 
     std::string display_date; // [176..183]
     std::string match_staff;  // [184..185]
@@ -199,6 +313,7 @@ struct TwseTransaction
 {
     std::string trade_date;      // [0..7]
     std::string securities_code; // [8..13]
+    uint32_t symbol_id = kNoSymbolId;
     BuySell buy_sell;            // [14]
     int trade_type_code;         // [15]
 
@@ -206,8 +321,9 @@ struct TwseTransaction
     std::string trade_number;    // [24..31]
     std::string order_number_ii; // [32..36]
 
-    float trade_price; // [37..43]
-    int trade_volume;  // [44..52]
+    float trade_price;            // [37..43]
+    PriceTicks trade_price_ticks; // same field, exact hundredths
+    int trade_volume;             // [44..52]
 
     std::string trading_report; // [53..56]
 
@@ -218,32 +334,19 @@ struct TwseTransaction
 
 //------------------------------------------------------------------------------
 // 3. Parse Functions
+//
+// The std::string entry points below forward to the allocation-free
+// string_view implementations in section 3.1, so both paths share one
+// field-offset table and the substr-per-field copies are gone everywhere.
 //------------------------------------------------------------------------------
 
+inline TwseOrderBook parseOrderLine(std::string_view line);
+inline TwseSnapshot parseSnapshotLine(std::string_view line);
+inline TwseTransaction parseTransactionLine(std::string_view line);
+
 inline TwseOrderBook parseOrderLine(const std::string &line)
 {
-    if (line.size() < 59)
-    {
-        throw std::runtime_error("Line too short (ODR requires 59 chars).");
-    }
-    TwseOrderBook rec;
-
-    rec.order_date = line.substr(0, 8);                              // [0..7]
-    rec.securities_code = rStrip(line.substr(8, 6));                 // [8..13]
-    rec.buy_sell = parseBuySell(line.substr(14, 1));                 // [14]
-    rec.trade_type_code = parseCode(line.substr(15, 1));             // [15]
-    rec.order_time = line.substr(16, 8);                             // [16..23]
-    rec.order_number_ii = line.substr(24, 5);                        // [24..28]
-    rec.changed_trade_code = parseCode(line.substr(29, 1));          // [29]
-    rec.order_price = parseFloat(line.substr(30, 7));                // [30..36]
-    rec.changed_trade_volume = parseSignAndInt(line.substr(37, 11)); // [37..47]
-    rec.order_type_code = parseCode(line.substr(48, 1));             // [48]
-    rec.notes_investors_channel = line.substr(49, 1);                // [49]
-    rec.order_report_print = line.substr(50, 4);                     // [50..53]
-    rec.type_of_investor = line.substr(54, 1);                       // [54]
-    rec.order_number_i = line.substr(55, 4);                         // [55..58]
-
-    return rec;
+    return parseOrderLine(std::string_view(line));
 }
 
 /*
@@ -282,6 +385,54 @@ inline TwseSnapshot parseSnapshotLine(const std::string &line)
 */
 
 inline TwseSnapshot parseSnapshotLine(const std::string &line)
+{
+    return parseSnapshotLine(std::string_view(line));
+}
+
+inline TwseTransaction parseTransactionLine(const std::string &line)
+{
+    return parseTransactionLine(std::string_view(line));
+}
+
+//------------------------------------------------------------------------------
+// 3.1 Zero-copy parse overloads (std::string_view)
+//
+// Same field layout as the std::string versions above, but the input line is
+// sliced in place (string_view::substr does not allocate) and numerics go
+// through std::from_chars, which needs no NUL terminator - so these can be
+// fed directly from a memory-mapped file (see twse_mmap.hpp) without copying
+// the line into a std::string first. Only the fields the structs actually own
+// as std::string are materialized.
+//------------------------------------------------------------------------------
+
+inline TwseOrderBook parseOrderLine(std::string_view line)
+{
+    if (line.size() < 59)
+    {
+        throw std::runtime_error("Line too short (ODR requires 59 chars).");
+    }
+    TwseOrderBook rec;
+
+    rec.order_date = std::string(line.substr(0, 8));                 // [0..7]
+    rec.securities_code = std::string(rStrip(line.substr(8, 6)));    // [8..13]
+    rec.buy_sell = parseBuySell(line[14]);                           // [14]
+    rec.trade_type_code = parseInt(line.substr(15, 1));              // [15]
+    rec.order_time = std::string(line.substr(16, 8));                // [16..23]
+    rec.order_number_ii = std::string(line.substr(24, 5));           // [24..28]
+    rec.changed_trade_code = parseInt(line.substr(29, 1));           // [29]
+    rec.order_price_ticks = parsePriceTicks(line.substr(30, 7));     // [30..36]
+    rec.order_price = ticksToPrice(rec.order_price_ticks);
+    rec.changed_trade_volume = parseSignAndInt(line.substr(37, 11)); // [37..47]
+    rec.order_type_code = parseInt(line.substr(48, 1));              // [48]
+    rec.notes_investors_channel = std::string(line.substr(49, 1));   // [49]
+    rec.order_report_print = std::string(line.substr(50, 4));        // [50..53]
+    rec.type_of_investor = std::string(line.substr(54, 1));          // [54]
+    rec.order_number_i = std::string(line.substr(55, 4));            // [55..58]
+
+    return rec;
+}
+
+inline TwseSnapshot parseSnapshotLine(std::string_view line)
 {
     if (line.size() < 186)
     {
@@ -289,58 +440,48 @@ inline TwseSnapshot parseSnapshotLine(const std::string &line)
     }
     TwseSnapshot snap;
 
-    snap.securities_code = rStrip(line.substr(0, 6));     // [0..5]
-    snap.display_time = line.substr(6, 8);                // [6..13]
-    snap.remark = line.substr(14, 1);                     // [14]
-    snap.trend_flag = line.substr(15, 1);                 // [15]
-    snap.match_flag = parseMatchFlag(line.substr(16, 1)); // [16]
-    snap.trade_upper_lower = line.substr(17, 1);          // [17]
+    snap.securities_code = std::string(rStrip(line.substr(0, 6))); // [0..5]
+    snap.display_time = std::string(line.substr(6, 8));            // [6..13]
+    snap.remark = std::string(line.substr(14, 1));                 // [14]
+    snap.trend_flag = std::string(line.substr(15, 1));             // [15]
+    snap.match_flag = parseMatchFlag(line[16]);                    // [16]
+    snap.trade_upper_lower = std::string(line.substr(17, 1));      // [17]
 
-    snap.trade_price = parse6digitPrice(line.substr(18, 6));         // [18..23]
-    snap.transaction_volume = std::atoi(line.substr(24, 8).c_str()); // [24..31]
+    snap.trade_price_ticks = parse6digitPriceTicks(line.substr(18, 6)); // [18..23]
+    snap.trade_price = ticksToPrice(snap.trade_price_ticks);
+    snap.transaction_volume = parseInt(line.substr(24, 8));  // [24..31]
 
-    snap.buy_tick_size = parseCode(line.substr(32, 1)); // [32]
-    snap.buy_upper_lower_limit = line.substr(33, 1);    // [33]
+    snap.buy_tick_size = parseInt(line.substr(32, 1));              // [32]
+    snap.buy_upper_lower_limit = std::string(line.substr(33, 1));   // [33]
 
-    // 70 chars for buy (35-104 => line[34..103])
-    // parse into snap.buy_prices / snap.buy_volumes
+    // 70 chars for buy (line[34..103]): 5 x (6-char price + 8-char volume)
+    for (int i = 0; i < 5; i++)
     {
-        // start offset = 34
-        // for i=0..4: parse 14 chars each
-        for (int i = 0; i < 5; i++)
-        {
-            int offset = 34 + i * 14;
-            std::string price_str = line.substr(offset, 6);      // 6 chars
-            std::string volume_str = line.substr(offset + 6, 8); // 8 chars
-
-            snap.buy_prices[i] = parse6digitPrice(price_str);
-            snap.buy_volumes[i] = std::atoi(volume_str.c_str());
-        }
+        size_t offset = 34 + i * 14;
+        snap.buy_price_ticks[i] = parse6digitPriceTicks(line.substr(offset, 6));
+        snap.buy_prices[i] = ticksToPrice(snap.buy_price_ticks[i]);
+        snap.buy_volumes[i] = parseInt(line.substr(offset + 6, 8));
     }
 
-    snap.sell_tick_size = parseCode(line.substr(104, 1)); // [104]
-    snap.sell_upper_lower_limit = line.substr(105, 1);    // [105]
+    snap.sell_tick_size = parseInt(line.substr(104, 1));            // [104]
+    snap.sell_upper_lower_limit = std::string(line.substr(105, 1)); // [105]
 
-    // 70 chars for sell (107-176 => line[106..175])
+    // 70 chars for sell (line[106..175])
+    for (int i = 0; i < 5; i++)
     {
-        for (int i = 0; i < 5; i++)
-        {
-            int offset = 106 + i * 14;
-            std::string price_str = line.substr(offset, 6);
-            std::string volume_str = line.substr(offset + 6, 8);
-
-            snap.sell_prices[i] = parse6digitPrice(price_str);
-            snap.sell_volumes[i] = std::atoi(volume_str.c_str());
-        }
+        size_t offset = 106 + i * 14;
+        snap.sell_price_ticks[i] = parse6digitPriceTicks(line.substr(offset, 6));
+        snap.sell_prices[i] = ticksToPrice(snap.sell_price_ticks[i]);
+        snap.sell_volumes[i] = parseInt(line.substr(offset + 6, 8));
     }
 
-    snap.display_date = line.substr(176, 8); // [176..183]
-    snap.match_staff = line.substr(184, 2);  // [184..185]
+    snap.display_date = std::string(line.substr(176, 8)); // [176..183]
+    snap.match_staff = std::string(line.substr(184, 2));  // [184..185]
 
     return snap;
 }
 
-inline TwseTransaction parseTransactionLine(const std::string &line)
+inline TwseTransaction parseTransactionLine(std::string_view line)
 {
     if (line.size() < 63)
     {
@@ -348,22 +489,23 @@ inline TwseTransaction parseTransactionLine(const std::string &line)
     }
     TwseTransaction tx;
 
-    tx.trade_date = line.substr(0, 8);                  // [0..7]
-    tx.securities_code = rStrip(line.substr(8, 6));     // [8..13]
-    tx.buy_sell = parseBuySell(line.substr(14, 1));     // [14]
-    tx.trade_type_code = parseCode(line.substr(15, 1)); // [15]
+    tx.trade_date = std::string(line.substr(0, 8));               // [0..7]
+    tx.securities_code = std::string(rStrip(line.substr(8, 6)));  // [8..13]
+    tx.buy_sell = parseBuySell(line[14]);                         // [14]
+    tx.trade_type_code = parseInt(line.substr(15, 1));            // [15]
 
-    tx.trade_time = line.substr(16, 8);      // [16..23]
-    tx.trade_number = line.substr(24, 8);    // [24..31]
-    tx.order_number_ii = line.substr(32, 5); // [32..36]
+    tx.trade_time = std::string(line.substr(16, 8));      // [16..23]
+    tx.trade_number = std::string(line.substr(24, 8));    // [24..31]
+    tx.order_number_ii = std::string(line.substr(32, 5)); // [32..36]
 
-    tx.trade_price = parseFloat(line.substr(37, 7));         // [37..43]
-    tx.trade_volume = std::atoi(line.substr(44, 9).c_str()); // [44..52]
+    tx.trade_price_ticks = parsePriceTicks(line.substr(37, 7)); // [37..43]
+    tx.trade_price = ticksToPrice(tx.trade_price_ticks);
+    tx.trade_volume = parseInt(line.substr(44, 9));   // [44..52]
 
-    tx.trading_report = line.substr(53, 4);             // [53..56]
-    tx.order_type_code = parseCode(line.substr(57, 1)); // [57]
-    tx.type_of_investor = line.substr(58, 1);           // [58]
-    tx.order_number_i = line.substr(59, 4);             // [59..62]
+    tx.trading_report = std::string(line.substr(53, 4));   // [53..56]
+    tx.order_type_code = parseInt(line.substr(57, 1));     // [57]
+    tx.type_of_investor = std::string(line.substr(58, 1)); // [58]
+    tx.order_number_i = std::string(line.substr(59, 4));   // [59..62]
 
     return tx;
 }
@@ -432,6 +574,73 @@ inline std::vector<TwseTransaction> loadMthFile(const std::string &filepath)
     return records;
 }
 
+//------------------------------------------------------------------------------
+// 4.1 Streaming loaders (bounded memory)
+//
+// The vector-returning loaders above materialize the whole file, which for a
+// full trading day of DSP data can run to tens of GB of RSS. These visitors
+// parse one record at a time from a single reused line buffer and hand it to
+// the callback, so peak memory is O(1) regardless of file size:
+//
+//     forEachSnapshot("snapshot/Sample", [&](const TwseSnapshot &snap) {
+//         ...
+//     });
+//------------------------------------------------------------------------------
+
+template <typename Fn>
+inline void forEachOrder(const std::string &filepath, Fn &&fn)
+{
+    std::ifstream fin(filepath, std::ios::binary);
+    if (!fin.is_open())
+    {
+        throw std::runtime_error("Cannot open ODR file: " + filepath);
+    }
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        if (line.size() == 59)
+        {
+            fn(parseOrderLine(line));
+        }
+    }
+}
+
+template <typename Fn>
+inline void forEachSnapshot(const std::string &filepath, Fn &&fn)
+{
+    std::ifstream fin(filepath, std::ios::binary);
+    if (!fin.is_open())
+    {
+        throw std::runtime_error("Cannot open DSP file: " + filepath);
+    }
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        if (line.size() == 186)
+        {
+            fn(parseSnapshotLine(line));
+        }
+    }
+}
+
+template <typename Fn>
+inline void forEachTransaction(const std::string &filepath, Fn &&fn)
+{
+    std::ifstream fin(filepath, std::ios::binary);
+    if (!fin.is_open())
+    {
+        throw std::runtime_error("Cannot open MTH file: " + filepath);
+    }
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        if (line.size() == 63)
+        {
+            fn(parseTransactionLine(line));
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 // 4. Struct to JSON
 //------------------------------------------------------------------------------
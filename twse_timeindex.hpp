@@ -0,0 +1,214 @@
+#ifndef TWSE_TIMEINDEX_HPP
+#define TWSE_TIMEINDEX_HPP
+
+// Time-bucketed seek index for partial-day loads.
+//
+// The daily files are time-ordered and every record carries an 8-char
+// HHMMSSxx time at a fixed offset (display_time at 6 for DSP, order_time /
+// trade_time at 16 for ODR/MTH). TimeIndex records, in one cheap pass that
+// decodes nothing but the time field, the byte offset of the first record of
+// each second present in the file. A range loader can then seek straight to
+// the bucket and parse only the slice it needs - a 30-minute window out of a
+// 10 GB day costs a few percent of a full load. The index can be persisted
+// as a small ".tidx" sidecar so later jobs skip even the scan pass.
+
+#include "twse_mmap.hpp"
+
+#include <algorithm> // for std::lower_bound
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// 1. TimeIndex
+//------------------------------------------------------------------------------
+
+// Byte offset within each format's record where the HHMMSSxx time field sits.
+constexpr size_t kOdrTimeOffset = 16;
+constexpr size_t kDspTimeOffset = 6;
+constexpr size_t kMthTimeOffset = 16;
+
+struct TimeBucket
+{
+    uint32_t hhmmss;     // first 6 digits of the time field
+    uint64_t byte_offset; // offset of the first record in this second
+};
+
+struct TimeIndex
+{
+    uint32_t record_width = 0;
+    uint32_t time_offset = 0;
+    std::vector<TimeBucket> buckets; // ascending hhmmss, one per second present
+
+    // Byte offset of the first record whose time is >= hhmmss (file size if
+    // the whole file is earlier - caller treats it as "nothing to read").
+    uint64_t seekOffset(uint32_t hhmmss, uint64_t file_size) const
+    {
+        auto it = std::lower_bound(buckets.begin(), buckets.end(), hhmmss,
+                                   [](const TimeBucket &b, uint32_t t)
+                                   { return b.hhmmss < t; });
+        return (it != buckets.end()) ? it->byte_offset : file_size;
+    }
+};
+
+// One pass over the mapped file, decoding only the 6 time digits per record.
+inline TimeIndex buildTimeIndex(std::string_view buffer, size_t record_width,
+                                size_t time_offset)
+{
+    TimeIndex index;
+    index.record_width = static_cast<uint32_t>(record_width);
+    index.time_offset = static_cast<uint32_t>(time_offset);
+    uint32_t last_second = 0xFFFFFFFFu;
+    const char *base = buffer.data();
+    forEachRawRecord(buffer, record_width, [&](std::string_view line)
+                     {
+        uint32_t second = static_cast<uint32_t>(parseInt(line.substr(time_offset, 6)));
+        if (second != last_second)
+        {
+            index.buckets.push_back({second, static_cast<uint64_t>(line.data() - base)});
+            last_second = second;
+        } });
+    return index;
+}
+
+inline TimeIndex buildTimeIndexFile(const std::string &filepath, size_t record_width,
+                                    size_t time_offset)
+{
+    MappedFile file(filepath);
+    return buildTimeIndex(file.view(), record_width, time_offset);
+}
+
+//------------------------------------------------------------------------------
+// 2. Sidecar persistence ("<data file>.tidx")
+//------------------------------------------------------------------------------
+
+constexpr uint32_t kTimeIndexMagic = 0x49545754; // "TWTI" little-endian
+
+inline void saveTimeIndex(const TimeIndex &index, const std::string &sidecar_path)
+{
+    std::ofstream out(sidecar_path, std::ios::binary);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("Cannot write time index: " + sidecar_path);
+    }
+    uint32_t magic = kTimeIndexMagic;
+    uint64_t count = index.buckets.size();
+    out.write(reinterpret_cast<const char *>(&magic), sizeof(magic));
+    out.write(reinterpret_cast<const char *>(&index.record_width), sizeof(index.record_width));
+    out.write(reinterpret_cast<const char *>(&index.time_offset), sizeof(index.time_offset));
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    for (const TimeBucket &b : index.buckets)
+    {
+        out.write(reinterpret_cast<const char *>(&b.hhmmss), sizeof(b.hhmmss));
+        out.write(reinterpret_cast<const char *>(&b.byte_offset), sizeof(b.byte_offset));
+    }
+}
+
+inline TimeIndex loadTimeIndexFile(const std::string &sidecar_path)
+{
+    std::ifstream in(sidecar_path, std::ios::binary);
+    if (!in.is_open())
+    {
+        throw std::runtime_error("Cannot open time index: " + sidecar_path);
+    }
+    uint32_t magic = 0;
+    uint64_t count = 0;
+    TimeIndex index;
+    in.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    if (magic != kTimeIndexMagic)
+    {
+        throw std::runtime_error("Not a TWTI time index: " + sidecar_path);
+    }
+    in.read(reinterpret_cast<char *>(&index.record_width), sizeof(index.record_width));
+    in.read(reinterpret_cast<char *>(&index.time_offset), sizeof(index.time_offset));
+    in.read(reinterpret_cast<char *>(&count), sizeof(count));
+    index.buckets.resize(count);
+    for (TimeBucket &b : index.buckets)
+    {
+        in.read(reinterpret_cast<char *>(&b.hhmmss), sizeof(b.hhmmss));
+        in.read(reinterpret_cast<char *>(&b.byte_offset), sizeof(b.byte_offset));
+    }
+    return index;
+}
+
+//------------------------------------------------------------------------------
+// 3. Range loaders
+//
+// Inclusive range [start_hhmmss, end_hhmmss], e.g. (90000, 93000) for the
+// first half hour. Pass a prebuilt/persisted index to skip the scan pass;
+// without one the index is built on the fly (still far cheaper than parsing).
+//------------------------------------------------------------------------------
+
+template <typename Record, typename ParseFn>
+inline std::vector<Record> loadFileRange(const std::string &filepath,
+                                         size_t record_width, size_t time_offset,
+                                         uint32_t start_hhmmss, uint32_t end_hhmmss,
+                                         ParseFn parse,
+                                         const TimeIndex *index = nullptr)
+{
+    MappedFile file(filepath);
+    TimeIndex local;
+    if (index == nullptr)
+    {
+        local = buildTimeIndex(file.view(), record_width, time_offset);
+        index = &local;
+    }
+    uint64_t begin = index->seekOffset(start_hhmmss, file.size());
+
+    std::vector<Record> records;
+    std::string_view rest = file.view().substr(begin);
+    const char *p = rest.data();
+    const char *end = p + rest.size();
+    while (p < end)
+    {
+        const char *nl = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        const char *line_end = (nl != nullptr) ? nl : end;
+        size_t len = static_cast<size_t>(line_end - p);
+        if (len == record_width)
+        {
+            std::string_view line(p, len);
+            uint32_t second = static_cast<uint32_t>(parseInt(line.substr(time_offset, 6)));
+            if (second > end_hhmmss)
+            {
+                break; // records are time-ordered; nothing later qualifies
+            }
+            if (second >= start_hhmmss)
+            {
+                records.push_back(parse(line));
+            }
+        }
+        if (nl == nullptr)
+        {
+            break;
+        }
+        p = nl + 1;
+    }
+    return records;
+}
+
+inline std::vector<TwseOrderBook> loadOdrFileRange(const std::string &filepath,
+                                                   uint32_t start_hhmmss, uint32_t end_hhmmss,
+                                                   const TimeIndex *index = nullptr)
+{
+    return loadFileRange<TwseOrderBook>(
+        filepath, 59, kOdrTimeOffset, start_hhmmss, end_hhmmss,
+        [](std::string_view line) { return parseOrderLine(line); }, index);
+}
+
+inline std::vector<TwseSnapshot> loadDspFileRange(const std::string &filepath,
+                                                  uint32_t start_hhmmss, uint32_t end_hhmmss,
+                                                  const TimeIndex *index = nullptr)
+{
+    return loadFileRange<TwseSnapshot>(
+        filepath, 186, kDspTimeOffset, start_hhmmss, end_hhmmss,
+        [](std::string_view line) { return parseSnapshotLine(line); }, index);
+}
+
+inline std::vector<TwseTransaction> loadMthFileRange(const std::string &filepath,
+                                                     uint32_t start_hhmmss, uint32_t end_hhmmss,
+                                                     const TimeIndex *index = nullptr)
+{
+    return loadFileRange<TwseTransaction>(
+        filepath, 63, kMthTimeOffset, start_hhmmss, end_hhmmss,
+        [](std::string_view line) { return parseTransactionLine(line); }, index);
+}
+
+#endif // TWSE_TIMEINDEX_HPP
@@ -0,0 +1,163 @@
+#ifndef TWSE_VALIDATE_HPP
+#define TWSE_VALIDATE_HPP
+
+// Fast record-geometry validation scan (no decoding).
+//
+// The loaders silently drop any line whose length isn't the expected
+// 59/186/63, so a truncated or corrupt archive only shows up as a wrong
+// record count after a full parse - hours into a batch conversion. This
+// scanner answers "is this file well-formed?" up front by touching every
+// byte but decoding nothing: memchr finds the newlines (vectorized in
+// libc), each line's length is checked against the record width, and a
+// word-at-a-time SWAR pass flags any byte outside printable ASCII (the
+// TWSE files are pure ' '..'~' text, so an embedded NUL or high byte
+// means binary corruption, not data). That makes the scan an order of
+// magnitude cheaper than a parse - a cheap admission gate to run before
+// committing a conversion to a questionable archive drop.
+//
+// The report keeps the first few bad offsets verbatim so a hexdump can
+// go straight to the damage; beyond that it only counts.
+
+#include "twse_mmap.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// 1. Report
+//------------------------------------------------------------------------------
+
+// One malformed stretch: a line whose length or bytes are wrong.
+struct ValidationIssue
+{
+    uint64_t offset; // byte offset of the line start in the file
+    uint32_t length; // line length found (excluding the newline)
+    bool non_ascii;  // true when the bytes, not the geometry, are bad
+};
+
+struct ValidationReport
+{
+    std::string filepath;
+    uint64_t file_size = 0;
+    uint64_t record_count = 0; // lines with the exact expected width
+    uint64_t bad_count = 0;    // lines that fail either check
+    bool trailing_newline = false;
+
+    // First few offenders, for hexdump-ing; bad_count keeps the full tally.
+    static constexpr size_t kMaxIssues = 16;
+    std::vector<ValidationIssue> issues;
+
+    bool clean() const { return bad_count == 0; }
+};
+
+//------------------------------------------------------------------------------
+// 2. SWAR printable-ASCII check
+//------------------------------------------------------------------------------
+
+// True when all `n` bytes are in [0x20, 0x7E] - eight bytes per iteration,
+// same trick family as twse_digits.hpp. A byte b is out of range when
+// b < 0x20 or b > 0x7E; both conditions fall out of the usual
+// borrow/carry masks against 0x80 lanes.
+inline bool allPrintableAscii(const char *p, size_t n)
+{
+    const unsigned char *u = reinterpret_cast<const unsigned char *>(p);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        uint64_t w;
+        __builtin_memcpy(&w, u + i, 8);
+        // below-0x20 lanes: subtracting 0x20 borrows into bit 7 of lanes < 0x20
+        uint64_t below = (w - 0x2020202020202020ULL) & ~w & 0x8080808080808080ULL;
+        // above-0x7E lanes: adding 0x01 carries past 0x7E only for 0x7F, and
+        // bytes >= 0x80 already have the high bit set
+        uint64_t above = ((w + 0x0101010101010101ULL) | w) & 0x8080808080808080ULL;
+        if ((below | above) != 0)
+        {
+            return false;
+        }
+    }
+    for (; i < n; i++)
+    {
+        if (u[i] < 0x20 || u[i] > 0x7E)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// 3. Scanner
+//------------------------------------------------------------------------------
+
+// Scan `filepath` as newline-delimited fixed-width records of `record_width`
+// chars. Touches every byte, decodes none of them. The last line may lack a
+// trailing newline (the TWSE sample files do); that is not an error.
+inline ValidationReport validateRecordFile(const std::string &filepath, size_t record_width)
+{
+    ValidationReport report;
+    report.filepath = filepath;
+    MappedFile file(filepath);
+    report.file_size = file.size();
+
+    const char *pos = file.data();
+    const char *end = pos + file.size();
+    while (pos < end)
+    {
+        const char *nl = static_cast<const char *>(
+            std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+        const char *line_end = (nl != nullptr) ? nl : end;
+        size_t len = static_cast<size_t>(line_end - pos);
+        bool geometry_ok = len == record_width;
+        bool bytes_ok = geometry_ok && allPrintableAscii(pos, len);
+        if (geometry_ok && bytes_ok)
+        {
+            report.record_count++;
+        }
+        else
+        {
+            report.bad_count++;
+            if (report.issues.size() < ValidationReport::kMaxIssues)
+            {
+                report.issues.push_back(ValidationIssue{
+                    static_cast<uint64_t>(pos - file.data()),
+                    static_cast<uint32_t>(len), geometry_ok});
+            }
+        }
+        if (nl == nullptr)
+        {
+            break;
+        }
+        pos = nl + 1;
+    }
+    report.trailing_newline = file.size() > 0 && *(end - 1) == '\n';
+    return report;
+}
+
+// One summary line per file, the shape the batch CLI prints:
+//   order/odr: OK (33 records, 1980 bytes)
+//   order/odr: 2 BAD lines of 35 (first: offset 118, length 58)
+inline std::string validationSummary(const ValidationReport &r)
+{
+    std::string out = r.filepath + ": ";
+    if (r.clean())
+    {
+        out += "OK (" + std::to_string(r.record_count) + " records, " +
+               std::to_string(r.file_size) + " bytes)";
+        return out;
+    }
+    out += std::to_string(r.bad_count) + " BAD lines of " +
+           std::to_string(r.record_count + r.bad_count);
+    if (!r.issues.empty())
+    {
+        const ValidationIssue &first = r.issues.front();
+        out += " (first: offset " + std::to_string(first.offset) +
+               (first.non_ascii ? ", non-ASCII bytes"
+                                : ", length " + std::to_string(first.length)) +
+               ")";
+    }
+    return out;
+}
+
+#endif // TWSE_VALIDATE_HPP